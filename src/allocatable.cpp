@@ -0,0 +1,87 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "allocatable.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+
+namespace
+{
+
+/*
+ * Every allocation is prefixed by a header that tells where the memory
+ * came from, so that deletion does not depend on the caller knowing it.
+ */
+struct Header
+{
+    std::pmr::memory_resource* resource;
+    std::size_t size;
+};
+
+constexpr std::size_t kAlignment = alignof(std::max_align_t);
+constexpr std::size_t kHeaderSize = (sizeof(Header) + kAlignment - 1) / kAlignment * kAlignment;
+
+Header* HeaderOf(const void* pointer)
+{
+    return reinterpret_cast<Header*>(
+            static_cast<char*>(const_cast<void*>(pointer)) - kHeaderSize);
+}
+
+}  // namespace
+
+void* Allocatable::operator new(std::size_t size)
+{
+    return operator new(size, std::pmr::get_default_resource());
+}
+
+void* Allocatable::operator new(std::size_t size, std::pmr::memory_resource* resource)
+{
+    char* block = static_cast<char*>(resource->allocate(kHeaderSize + size, kAlignment));
+    Header* header = reinterpret_cast<Header*>(block);
+    header->resource = resource;
+    header->size = kHeaderSize + size;
+    return block + kHeaderSize;
+}
+
+void Allocatable::operator delete(void* pointer)
+{
+    if (!pointer)
+    {
+        return;
+    }
+    Header* header = HeaderOf(pointer);
+    header->resource->deallocate(header, header->size, kAlignment);
+}
+
+void Allocatable::operator delete(void* pointer, std::pmr::memory_resource* /* resource */)
+{
+    operator delete(pointer);
+}
+
+std::pmr::memory_resource* Allocatable::GetResource(const Allocatable* object)
+{
+    return HeaderOf(object)->resource;
+}
+
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_ALLOCATABLE_HPP_
+#define SRC_ALLOCATABLE_HPP_
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace deepnum
+{
+namespace clarith
+{
+
+/**
+ * Allocation from caller supplied memory resources.
+ * Dynamically allocated instances of derived classes can be placed in any
+ * std::pmr::memory_resource with `new (resource) T(...)`, and are released
+ * with a plain `delete` regardless of where they were allocated from.
+ * Plain `new T(...)` allocates from std::pmr::get_default_resource().
+ *
+ * Building a whole expression graph in a std::pmr::monotonic_buffer_resource
+ * saves most of its allocation cost. Its root must still be deleted before
+ * the resource is released: arbitrary precision coefficients
+ * (arithmetic::Integer), packed sequences (protocol::Buffer), cycle
+ * detectors, tees and expression graphs keep state in the global heap that
+ * only their destructors give back.
+ * \see Number, strategy::Strategy
+ */
+class Allocatable
+{
+ public:
+
+    static void* operator new(std::size_t size);
+    static void* operator new(std::size_t size, std::pmr::memory_resource* resource);
+    static void operator delete(void* pointer);
+    static void operator delete(void* pointer, std::pmr::memory_resource* resource);
+
+ protected:
+
+    /**
+     * Memory resource of a dynamically allocated object.
+     * \param[in] object Object allocated by Allocatable::operator new.
+     * \pre object is not null, and was dynamically allocated: objects on
+     *      the stack, in containers or in place of members have no
+     *      memory resource to tell.
+     * \return Memory resource object was allocated from.
+     */
+    static std::pmr::memory_resource* GetResource(const Allocatable* object);
+};
+
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_ALLOCATABLE_HPP_
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_ARITHMETIC_BITS_HPP_
+#define SRC_ARITHMETIC_BITS_HPP_
+
+#include <cstdint>
+
+#include "integer.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace arithmetic
+{
+
+/**
+ * \return Number of significant bits of x.
+ */
+inline unsigned int BitLength(unsigned int x) { return x ? 8 * sizeof(x) - __builtin_clz(x) : 0; }
+inline unsigned int BitLength(unsigned long x) { return x ? 8 * sizeof(x) - __builtin_clzl(x) : 0; }
+inline unsigned int BitLength(unsigned long long x) { return x ? 8 * sizeof(x) - __builtin_clzll(x) : 0; }
+inline unsigned int BitLength(unsigned __int128 x)
+{
+    std::uint64_t high = x >> 64;
+    return high ? 128 - __builtin_clzll(high) : BitLength(std::uint64_t(x));
+}
+inline unsigned int BitLength(const Integer& x) { return x.BitLength(); }
+
+/**
+ * \return Number of trailing zero bits of x.
+ * \pre x is not zero.
+ */
+inline unsigned int CountTrailingZeros(unsigned int x) { return __builtin_ctz(x); }
+inline unsigned int CountTrailingZeros(unsigned long x) { return __builtin_ctzl(x); }
+inline unsigned int CountTrailingZeros(unsigned long long x) { return __builtin_ctzll(x); }
+inline unsigned int CountTrailingZeros(unsigned __int128 x)
+{
+    std::uint64_t low = x;
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(std::uint64_t(x >> 64));
+}
+inline unsigned int CountTrailingZeros(const Integer& x) { return x.TrailingZeros(); }
+
+/**
+ * Greatest common divisor, by the binary (Stein's) algorithm.
+ * \tparam U Unsigned integer type.
+ * \return Greatest common divisor of a and b; zero if both are zero.
+ */
+template <typename U>
+U Gcd(U a, U b)
+{
+    if (!a)
+    {
+        return b;
+    }
+    if (!b)
+    {
+        return a;
+    }
+    unsigned int shift = CountTrailingZeros(a | b);
+    a >>= CountTrailingZeros(a);
+    do
+    {
+        b >>= CountTrailingZeros(b);
+        if (a > b)
+        {
+            U aux = a;
+            a = b;
+            b = aux;
+        }
+        b -= a;
+    } while (b);
+    return a << shift;
+}
+
+}  // namespace arithmetic
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_ARITHMETIC_BITS_HPP_
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_ARITHMETIC_CHECKED_HPP_
+#define SRC_ARITHMETIC_CHECKED_HPP_
+
+#include <cstdint>
+#include <limits>
+
+#include "integer.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace arithmetic
+{
+
+/*
+ * Checked arithmetic.
+ * Each operation stores its result and answers true, or answers false
+ * if the result does not fit in T.
+ * Integer operations never fail.
+ */
+
+template <typename T>
+bool Add(T a, T b, T* result) { return !__builtin_add_overflow(a, b, result); }
+
+template <typename T>
+bool Sub(T a, T b, T* result) { return !__builtin_sub_overflow(a, b, result); }
+
+template <typename T>
+bool Mul(T a, T b, T* result) { return !__builtin_mul_overflow(a, b, result); }
+
+inline bool Add(const Integer& a, const Integer& b, Integer* result) { *result = a + b; return true; }
+inline bool Sub(const Integer& a, const Integer& b, Integer* result) { *result = a - b; return true; }
+inline bool Mul(const Integer& a, const Integer& b, Integer* result) { *result = a * b; return true; }
+
+template <typename T>
+bool Negate(T* a) { return Sub(T(0), *a, a); }
+
+/**
+ * Checked \f$xu+yv\f$.
+ */
+template <typename T>
+bool Dot(const T& x, const T& u, const T& y, const T& v, T* result)
+{
+    T xu, yv;
+    return Mul(x, u, &xu) && Mul(y, v, &yv) && Add(xu, yv, result);
+}
+
+/**
+ * Next type in the promotion chain int, std::int64_t, __int128, Integer.
+ */
+template <typename T>
+struct Wider;
+
+template <>
+struct Wider<int> { using type = std::int64_t; };
+
+template <>
+struct Wider<std::int64_t> { using type = __int128; };
+
+template <>
+struct Wider<__int128> { using type = Integer; };
+
+/**
+ * Absolute value of a signed machine integer,
+ * without overflow on the lowest value.
+ */
+inline unsigned int Magnitude(int x) { return x < 0 ? 0u - unsigned(x) : unsigned(x); }
+inline std::uint64_t Magnitude(std::int64_t x) { return x < 0 ? 0u - std::uint64_t(x) : std::uint64_t(x); }
+inline unsigned __int128 Magnitude(__int128 x)
+{
+    return x < 0 ? 0u - static_cast<unsigned __int128>(x) : static_cast<unsigned __int128>(x);
+}
+
+/**
+ * Exact division of x by a divisor of its magnitude.
+ */
+template <typename T, typename U>
+T Divide(T x, U divisor)
+{
+    U quotient = Magnitude(x) / divisor;
+    return x < 0 ? T(U(0) - quotient) : T(quotient);
+}
+
+/**
+ * \return Does x fit in T?
+ */
+template <typename T>
+bool Fits(__int128 x)
+{
+    return x >= std::numeric_limits<T>::min() && x <= std::numeric_limits<T>::max();
+}
+
+}  // namespace arithmetic
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_ARITHMETIC_CHECKED_HPP_
@@ -0,0 +1,359 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "integer.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace arithmetic
+{
+
+namespace
+{
+
+constexpr unsigned int kLimbBits = 32;
+
+template <typename S>
+unsigned __int128 AbsoluteValue(S value)
+{
+    return value >= 0 ? static_cast<unsigned __int128>(value)
+                      : static_cast<unsigned __int128>(0) - static_cast<unsigned __int128>(value);
+}
+
+}  // namespace
+
+Integer::Integer(int value) { Assign(AbsoluteValue(value), value < 0); }
+Integer::Integer(long value) { Assign(AbsoluteValue(value), value < 0); }
+Integer::Integer(long long value) { Assign(AbsoluteValue(value), value < 0); }
+Integer::Integer(unsigned int value) { Assign(value, false); }
+Integer::Integer(unsigned long value) { Assign(value, false); }
+Integer::Integer(unsigned long long value) { Assign(value, false); }
+Integer::Integer(__int128 value) { Assign(AbsoluteValue(value), value < 0); }
+Integer::Integer(unsigned __int128 value) { Assign(value, false); }
+
+void Integer::Assign(unsigned __int128 magnitude, bool negative)
+{
+    magnitude_.clear();
+    for (; magnitude; magnitude >>= kLimbBits)
+    {
+        magnitude_.push_back(Limb(magnitude));
+    }
+    negative_ = negative && !magnitude_.empty();
+}
+
+void Integer::Trim()
+{
+    while (!magnitude_.empty() && !magnitude_.back())
+    {
+        magnitude_.pop_back();
+    }
+    if (magnitude_.empty())
+    {
+        negative_ = false;
+    }
+}
+
+Integer::operator bool() const
+{
+    return !magnitude_.empty();
+}
+
+int Integer::Sign() const
+{
+    return magnitude_.empty() ? 0 : negative_ ? -1 : 1;
+}
+
+std::size_t Integer::BitLength() const
+{
+    if (magnitude_.empty())
+    {
+        return 0;
+    }
+    return magnitude_.size() * kLimbBits - __builtin_clz(magnitude_.back());
+}
+
+std::size_t Integer::TrailingZeros() const
+{
+    std::size_t limbs = 0;
+    while (!magnitude_[limbs])
+    {
+        ++limbs;
+    }
+    return limbs * kLimbBits + __builtin_ctz(magnitude_[limbs]);
+}
+
+Integer Integer::operator-() const
+{
+    Integer result = *this;
+    result.negative_ = !negative_ && !magnitude_.empty();
+    return result;
+}
+
+int Integer::CompareMagnitudes(const Magnitude& a, const Magnitude& b)
+{
+    if (a.size() != b.size())
+    {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    for (std::size_t i = a.size(); i-- > 0;)
+    {
+        if (a[i] != b[i])
+        {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+int Integer::Compare(const Integer& a, const Integer& b)
+{
+    int a_sign = a.Sign();
+    int b_sign = b.Sign();
+    if (a_sign != b_sign)
+    {
+        return a_sign < b_sign ? -1 : 1;
+    }
+    int result = CompareMagnitudes(a.magnitude_, b.magnitude_);
+    return a_sign < 0 ? -result : result;
+}
+
+void Integer::Add(const Integer& other, bool negate)
+{
+    bool other_negative = other.negative_ != negate && !other.magnitude_.empty();
+    if (negative_ == other_negative || magnitude_.empty())
+    {
+        // Same signs: add magnitudes.
+        negative_ = other_negative;
+        if (magnitude_.size() < other.magnitude_.size())
+        {
+            magnitude_.resize(other.magnitude_.size());
+        }
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < magnitude_.size(); ++i)
+        {
+            carry += magnitude_[i];
+            if (i < other.magnitude_.size())
+            {
+                carry += other.magnitude_[i];
+            }
+            magnitude_[i] = Limb(carry);
+            carry >>= kLimbBits;
+        }
+        if (carry)
+        {
+            magnitude_.push_back(Limb(carry));
+        }
+        return;
+    }
+    // Opposite signs: subtract the lesser magnitude from the greater one.
+    const Magnitude* big = &magnitude_;
+    const Magnitude* small = &other.magnitude_;
+    if (CompareMagnitudes(magnitude_, other.magnitude_) < 0)
+    {
+        std::swap(big, small);
+        negative_ = other_negative;
+    }
+    Magnitude result(big->size());
+    std::int64_t borrow = 0;
+    for (std::size_t i = 0; i < big->size(); ++i)
+    {
+        std::int64_t difference = std::int64_t((*big)[i]) - borrow;
+        if (i < small->size())
+        {
+            difference -= (*small)[i];
+        }
+        borrow = difference < 0;
+        result[i] = Limb(difference + (borrow << kLimbBits));
+    }
+    magnitude_ = std::move(result);
+    Trim();
+}
+
+Integer& Integer::operator+=(const Integer& other)
+{
+    Add(other, false);
+    return *this;
+}
+
+Integer& Integer::operator-=(const Integer& other)
+{
+    Add(other, true);
+    return *this;
+}
+
+Integer& Integer::operator*=(const Integer& other)
+{
+    if (magnitude_.empty() || other.magnitude_.empty())
+    {
+        magnitude_.clear();
+        negative_ = false;
+        return *this;
+    }
+    Magnitude result(magnitude_.size() + other.magnitude_.size());
+    for (std::size_t i = 0; i < magnitude_.size(); ++i)
+    {
+        std::uint64_t carry = 0;
+        for (std::size_t j = 0; j < other.magnitude_.size(); ++j)
+        {
+            carry += std::uint64_t(magnitude_[i]) * other.magnitude_[j] + result[i + j];
+            result[i + j] = Limb(carry);
+            carry >>= kLimbBits;
+        }
+        result[i + other.magnitude_.size()] = Limb(carry);
+    }
+    magnitude_ = std::move(result);
+    negative_ = negative_ != other.negative_;
+    Trim();
+    return *this;
+}
+
+Integer& Integer::operator/=(std::uint32_t divisor)
+{
+    std::uint64_t remainder = 0;
+    for (std::size_t i = magnitude_.size(); i-- > 0;)
+    {
+        remainder = remainder << kLimbBits | magnitude_[i];
+        magnitude_[i] = Limb(remainder / divisor);
+        remainder %= divisor;
+    }
+    Trim();
+    return *this;
+}
+
+Integer operator%(const Integer& a, std::uint32_t b)
+{
+    std::uint64_t remainder = 0;
+    for (std::size_t i = a.magnitude_.size(); i-- > 0;)
+    {
+        remainder = (remainder << kLimbBits | a.magnitude_[i]) % b;
+    }
+    Integer result(static_cast<unsigned long long>(remainder));
+    return a.negative_ ? -result : result;
+}
+
+Integer& Integer::operator<<=(unsigned int bits)
+{
+    if (magnitude_.empty())
+    {
+        return *this;
+    }
+    unsigned int limbs = bits / kLimbBits;
+    bits %= kLimbBits;
+    if (bits)
+    {
+        magnitude_.push_back(0);
+        for (std::size_t i = magnitude_.size() - 1; i > 0; --i)
+        {
+            magnitude_[i] = magnitude_[i] << bits | magnitude_[i - 1] >> (kLimbBits - bits);
+        }
+        magnitude_[0] <<= bits;
+    }
+    magnitude_.insert(magnitude_.begin(), limbs, 0);
+    Trim();
+    return *this;
+}
+
+Integer& Integer::operator>>=(unsigned int bits)
+{
+    unsigned int limbs = bits / kLimbBits;
+    bits %= kLimbBits;
+    if (limbs >= magnitude_.size())
+    {
+        magnitude_.clear();
+        negative_ = false;
+        return *this;
+    }
+    magnitude_.erase(magnitude_.begin(), magnitude_.begin() + limbs);
+    if (bits)
+    {
+        for (std::size_t i = 0; i + 1 < magnitude_.size(); ++i)
+        {
+            magnitude_[i] = magnitude_[i] >> bits | magnitude_[i + 1] << (kLimbBits - bits);
+        }
+        magnitude_.back() >>= bits;
+    }
+    Trim();
+    return *this;
+}
+
+#if TRACE
+std::ostream& operator<<(std::ostream& os, const Integer& value)
+{
+    // Peel off nine decimal digits at a time.
+    constexpr std::uint32_t kChunk = 1000000000;
+    Integer x = value;
+    std::string digits;
+    do
+    {
+        std::uint64_t remainder = 0;
+        for (std::size_t i = x.magnitude_.size(); i-- > 0;)
+        {
+            remainder = (remainder << kLimbBits | x.magnitude_[i]) % kChunk;
+        }
+        x /= kChunk;
+        std::string chunk = std::to_string(remainder);
+        if (x)
+        {
+            chunk.insert(0, 9 - chunk.size(), '0');
+        }
+        digits.insert(0, chunk);
+    } while (x);
+    if (value.negative_)
+    {
+        os << '-';
+    }
+    return os << digits;
+}
+#endif  // TRACE
+
+}  // namespace arithmetic
+
+#if TRACE
+std::ostream& operator<<(std::ostream& os, unsigned __int128 value)
+{
+    char digits[40];
+    char* p = digits + sizeof(digits);
+    *--p = '\0';
+    do
+    {
+        *--p = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    return os << p;
+}
+
+std::ostream& operator<<(std::ostream& os, __int128 value)
+{
+    if (value < 0)
+    {
+        os << '-';
+    }
+    return os << arithmetic::AbsoluteValue(value);
+}
+#endif  // TRACE
+
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_ARITHMETIC_INTEGER_HPP_
+#define SRC_ARITHMETIC_INTEGER_HPP_
+
+#include <config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if TRACE
+#include <iostream>
+#endif  // TRACE
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace arithmetic
+{
+
+/**
+ * Arbitrary precision signed integer.
+ * This is the last resort of strategies whose machine integers overflow;
+ * it provides only the operations they need.
+ */
+class Integer
+{
+ public:
+
+    Integer() = default;
+    Integer(int value);
+    Integer(long value);
+    Integer(long long value);
+    Integer(unsigned int value);
+    Integer(unsigned long value);
+    Integer(unsigned long long value);
+    Integer(__int128 value);
+    Integer(unsigned __int128 value);
+
+    /**
+     * \return Is it not zero?
+     */
+    explicit operator bool() const;
+
+    /**
+     * \return -1, 0 or +1 according to the sign.
+     */
+    int Sign() const;
+
+    /**
+     * \return Number of significant bits of the absolute value.
+     */
+    std::size_t BitLength() const;
+
+    /**
+     * \return Number of trailing zero bits of the absolute value.
+     * \pre Not zero.
+     */
+    std::size_t TrailingZeros() const;
+
+    Integer operator-() const;
+    Integer& operator+=(const Integer& other);
+    Integer& operator-=(const Integer& other);
+    Integer& operator*=(const Integer& other);
+
+    /**
+     * Division by a machine integer, truncated towards zero.
+     * \pre divisor is not zero.
+     */
+    Integer& operator/=(std::uint32_t divisor);
+
+    /**
+     * Shifts of the absolute value; the sign is kept.
+     */
+    Integer& operator<<=(unsigned int bits);
+    Integer& operator>>=(unsigned int bits);
+
+    friend Integer operator+(Integer a, const Integer& b) { return a += b; }
+    friend Integer operator-(Integer a, const Integer& b) { return a -= b; }
+    friend Integer operator*(Integer a, const Integer& b) { return a *= b; }
+    friend Integer operator/(Integer a, std::uint32_t b) { return a /= b; }
+    friend Integer operator%(const Integer& a, std::uint32_t b);
+    friend Integer operator<<(Integer a, unsigned int bits) { return a <<= bits; }
+    friend Integer operator>>(Integer a, unsigned int bits) { return a >>= bits; }
+
+    friend bool operator==(const Integer& a, const Integer& b) { return Compare(a, b) == 0; }
+    friend bool operator!=(const Integer& a, const Integer& b) { return Compare(a, b) != 0; }
+    friend bool operator<(const Integer& a, const Integer& b) { return Compare(a, b) < 0; }
+    friend bool operator>(const Integer& a, const Integer& b) { return Compare(a, b) > 0; }
+    friend bool operator<=(const Integer& a, const Integer& b) { return Compare(a, b) <= 0; }
+    friend bool operator>=(const Integer& a, const Integer& b) { return Compare(a, b) >= 0; }
+
+#if TRACE
+    friend std::ostream& operator<<(std::ostream& os, const Integer& value);
+#endif  // TRACE
+
+ private:
+    using Limb = std::uint32_t;
+    using Magnitude = std::vector<Limb>;
+
+    void Assign(unsigned __int128 magnitude, bool negative);
+    void Trim();
+    void Add(const Integer& other, bool negate);
+    static int Compare(const Integer& a, const Integer& b);
+    static int CompareMagnitudes(const Magnitude& a, const Magnitude& b);
+
+    // Little endian limbs, without leading zeros; empty if zero.
+    Magnitude magnitude_;
+    bool negative_ { false };
+};
+
+}  // namespace arithmetic
+
+#if TRACE
+std::ostream& operator<<(std::ostream& os, __int128 value);
+std::ostream& operator<<(std::ostream& os, unsigned __int128 value);
+#endif  // TRACE
+
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_ARITHMETIC_INTEGER_HPP_
@@ -0,0 +1,435 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include "allocatable.hpp"
+#include "memo.hpp"
+#include "number.hpp"
+#include "protocol/protocol.hpp"
+#include "raise.hpp"
+#include "strategy/bihomography.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/ratio.hpp"
+#include "strategy/strategy.hpp"
+#include "strategy/terms.hpp"
+#include "strategy/unavailable_error.hpp"
+#include "strategy/undefined_ratio_error.hpp"
+#include "strategy/zero.hpp"
+
+#include "expression.hpp"
+
+#include "tracelog.h"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Strategy;
+using deepnum::clarith::strategy::UndefinedRatioError;
+
+namespace deepnum
+{
+namespace clarith
+{
+
+namespace
+{
+
+/*
+ * Reduces coefficients by their common factor, and signs them so that
+ * the first of the denominator coefficients that is not zero is positive.
+ * Coefficients that cannot be negated are left with their sign.
+ */
+template <std::size_t N>
+void Normalize(int* const (&numerator)[N], int* const (&denominator)[N])
+{
+    int* terms[2 * N];
+    std::copy(std::begin(numerator), std::end(numerator), terms);
+    std::copy(std::begin(denominator), std::end(denominator), terms + N);
+    auto leading = std::find_if(std::begin(denominator), std::end(denominator), [](const int* a) { return *a; });
+    if (leading == std::end(denominator))
+    {
+        Raise<UndefinedRatioError>();
+    }
+    strategy::ReduceTerms(terms);
+    if (**leading > 0 || std::any_of(std::begin(terms), std::end(terms), [](const int* a) { return *a == INT_MIN; }))
+    {
+        return;
+    }
+    for (int* a : terms)
+    {
+        *a = -*a;
+    }
+}
+
+}  // namespace
+
+/**
+ * Interned expression.
+ * The messages of an operation are computed by a Memo, read by every
+ * number that evaluates the node.
+ */
+class Expression::Node : public Allocatable
+{
+ public:
+
+    Node(Graph* graph, const Graph::Key& key, std::uint64_t id)
+            : graph_(graph),
+            key_(key),
+            id_(id),
+            references_(1),
+            memo_(nullptr)
+    {
+        tracelog(this << " " << static_cast<int>(key.kind));
+        for (Node* input : { key_.x, key_.y })
+        {
+            if (input)
+            {
+                input->Retain();
+            }
+        }
+    }
+
+    ~Node()
+    {
+        tracelog(this);
+        // Readers of the inputs go first, then the inputs themselves.
+        delete memo_;
+        for (Node* input : { key_.x, key_.y })
+        {
+            if (input)
+            {
+                input->Release();
+            }
+        }
+    }
+
+    void Retain()
+    {
+        ++references_;
+    }
+
+    void Release()
+    {
+        if (!--references_)
+        {
+            graph_->Forget(key_);
+            delete this;
+        }
+    }
+
+    std::uint64_t Id() const
+    {
+        return id_;
+    }
+
+    Number* Evaluate();
+
+    std::size_t Computed() const
+    {
+        return memo_ ? memo_->Cache().Size() : 0;
+    }
+
+    Memo* GetMemo()
+    {
+        if (!memo_)
+        {
+            memo_ = new (graph_->resource_) Memo(Compute());
+        }
+        return memo_;
+    }
+
+ private:
+
+    Number* Compute() const
+    {
+        const int* c = key_.c;
+        if (key_.kind == Graph::Kind::Homography)
+        {
+            return strategy::Homography::Make(key_.x->Evaluate(), c[0], c[1], c[2], c[3]);
+        }
+        Number* x = key_.x->Evaluate();
+        Number* y = key_.y->Evaluate();
+        return new (graph_->resource_) Number(new (graph_->resource_) strategy::Bihomography(
+                x, y, c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7]));
+    }
+
+    Graph* graph_;
+    Graph::Key key_;
+    std::uint64_t id_;
+    std::size_t references_;
+    // Null until first evaluated, and for ratio leaves.
+    Memo* memo_;
+};
+
+/**
+ * Reads the shared stream of a node, which it keeps alive.
+ */
+class Expression::Reader : public Strategy
+{
+ public:
+
+    explicit Reader(Node* node)
+            : node_(node)
+    {
+        tracelog(node);
+        node_->Retain();
+    }
+
+    ~Reader()
+    {
+        tracelog("");
+        node_->Release();
+    }
+
+    bool Egest(Protocol* message) override
+    {
+        Memo* memo = node_->GetMemo();
+        if (!memo->Fill(position_ + 1))
+        {
+            return false;
+        }
+        *message = memo->Cache()[position_++];
+        return true;
+    }
+
+    std::size_t EgestMany(Protocol* out, std::size_t max) override
+    {
+        Memo* memo = node_->GetMemo();
+        memo->Fill(position_ + max);
+        std::size_t count = memo->Cache().Read(position_, out, max);
+        position_ += count;
+        return count;
+    }
+
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override
+    {
+        const protocol::Buffer& cache = node_->GetMemo()->Cache();
+        if (!cache.IsTerminated() || position_ != cache.Size())
+        {
+            Raise<strategy::UnavailableError>();
+        }
+        return new (resource) strategy::Zero();
+    }
+
+ private:
+
+    Node* node_;
+    std::size_t position_ { 0 };
+};
+
+Number* Expression::Node::Evaluate()
+{
+    if (key_.kind == Graph::Kind::Ratio)
+    {
+        return new (graph_->resource_) Number(std::in_place_type<strategy::Ratio>, key_.c[0], key_.c[1]);
+    }
+    return new (graph_->resource_) Number(new (graph_->resource_) Reader(this));
+}
+
+Expression::Expression(Node* node)
+        : node_(node)
+{
+}
+
+Expression::Expression(const Expression& other)
+        : node_(other.node_)
+{
+    if (node_)
+    {
+        node_->Retain();
+    }
+}
+
+Expression& Expression::operator=(const Expression& other)
+{
+    // Retain first, in case both refer to the same node.
+    if (other.node_)
+    {
+        other.node_->Retain();
+    }
+    if (node_)
+    {
+        node_->Release();
+    }
+    node_ = other.node_;
+    return *this;
+}
+
+Expression::Expression(Expression&& other) noexcept
+        : node_(std::exchange(other.node_, nullptr))
+{
+}
+
+Expression& Expression::operator=(Expression&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (node_)
+        {
+            node_->Release();
+        }
+        node_ = std::exchange(other.node_, nullptr);
+    }
+    return *this;
+}
+
+Expression::~Expression()
+{
+    if (node_)
+    {
+        node_->Release();
+    }
+}
+
+Number* Expression::Evaluate() const
+{
+    return node_->Evaluate();
+}
+
+std::size_t Expression::Computed() const
+{
+    return node_->Computed();
+}
+
+bool Expression::operator==(const Expression& other) const
+{
+    return node_ == other.node_;
+}
+
+bool Expression::operator!=(const Expression& other) const
+{
+    return node_ != other.node_;
+}
+
+bool Graph::Key::operator==(const Key& other) const
+{
+    return kind == other.kind && x == other.x && y == other.y && std::equal(c, c + 8, other.c);
+}
+
+std::size_t Graph::KeyHash::operator()(const Key& key) const
+{
+    std::size_t hash = static_cast<std::size_t>(key.kind);
+    auto mix = [&hash](std::size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+    mix(reinterpret_cast<std::uintptr_t>(key.x));
+    mix(reinterpret_cast<std::uintptr_t>(key.y));
+    for (int a : key.c)
+    {
+        mix(static_cast<unsigned int>(a));
+    }
+    return hash;
+}
+
+Graph::Graph(std::pmr::memory_resource* resource)
+        : resource_(resource),
+        next_id_(0)
+{
+    tracelog(this);
+}
+
+Graph::~Graph()
+{
+    tracelog(this);
+}
+
+Expression Graph::Ratio(int n, int d)
+{
+    Key key { Kind::Ratio, nullptr, nullptr, { n, d } };
+    Normalize({ &key.c[0] }, { &key.c[1] });
+    return Intern(key);
+}
+
+Expression Graph::Homography(const Expression& x, int n1, int n0, int d1, int d0)
+{
+    Key key { Kind::Homography, x.node_, nullptr, { n1, n0, d1, d0 } };
+    Normalize({ &key.c[0], &key.c[1] }, { &key.c[2], &key.c[3] });
+    if (key.c[0] == key.c[3] && !key.c[1] && !key.c[2])
+    {
+        // Identity.
+        return x;
+    }
+    return Intern(key);
+}
+
+Expression Graph::Bihomography(const Expression& x, const Expression& y,
+                               int n11, int n10, int n01, int n00, int d11, int d10, int d01, int d00)
+{
+    Key key { Kind::Bihomography, x.node_, y.node_, { n11, n10, n01, n00, d11, d10, d01, d00 } };
+    int* c = key.c;
+    Normalize({ &c[0], &c[1], &c[2], &c[3] }, { &c[4], &c[5], &c[6], &c[7] });
+    if (key.x->Id() > key.y->Id())
+    {
+        // Swapping the operands swaps their coefficients.
+        std::swap(key.x, key.y);
+        std::swap(c[1], c[2]);
+        std::swap(c[5], c[6]);
+    }
+    return Intern(key);
+}
+
+Expression Graph::Sum(const Expression& x, const Expression& y)
+{
+    return Bihomography(x, y, 0, 1, 1, 0, 0, 0, 0, 1);
+}
+
+Expression Graph::Difference(const Expression& x, const Expression& y)
+{
+    return Bihomography(x, y, 0, 1, -1, 0, 0, 0, 0, 1);
+}
+
+Expression Graph::Product(const Expression& x, const Expression& y)
+{
+    return Bihomography(x, y, 1, 0, 0, 0, 0, 0, 0, 1);
+}
+
+Expression Graph::Quotient(const Expression& x, const Expression& y)
+{
+    return Bihomography(x, y, 0, 1, 0, 0, 0, 0, 1, 0);
+}
+
+std::size_t Graph::Size() const
+{
+    return nodes_.size();
+}
+
+Expression Graph::Intern(const Key& key)
+{
+    auto [it, inserted] = nodes_.try_emplace(key, nullptr);
+    if (!inserted)
+    {
+        tracelog("interned " << it->second);
+        it->second->Retain();
+        return Expression(it->second);
+    }
+    it->second = new (resource_) Expression::Node(this, key, next_id_++);
+    return Expression(it->second);
+}
+
+void Graph::Forget(const Key& key)
+{
+    nodes_.erase(key);
+}
+
+}  // namespace clarith
+}  // namespace deepnum
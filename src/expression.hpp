@@ -0,0 +1,216 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_EXPRESSION_HPP_
+#define SRC_EXPRESSION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+
+#include <gsl/gsl>
+
+namespace deepnum
+{
+namespace clarith
+{
+
+class Graph;
+class Number;
+
+/**
+ * Shared reference to a node of an expression Graph.
+ * Expressions are cheap to copy: copies refer to the same node, which
+ * lives as long as any expression, any node built on it, or any number
+ * evaluating it refers to it.
+ *
+ * Expressions must not outlive their graph, and moved-from expressions
+ * can only be assigned to or destroyed.
+ * \see Graph
+ */
+class Expression
+{
+ public:
+
+    Expression(const Expression& other);
+    Expression& operator=(const Expression& other);
+    Expression(Expression&& other) noexcept;
+    Expression& operator=(Expression&& other) noexcept;
+
+    ~Expression();
+
+    /**
+     * Number that reads the value of the expression from its first message.
+     * Every number evaluating a node reads the same stream of messages,
+     * so each message of a node is computed only once, however many
+     * numbers and nodes read it.
+     * Ratio leaves are lighter to compute than to replay; each of their
+     * numbers computes its own messages.
+     * \return New number, that must not outlive the graph.
+     */
+    gsl::owner<Number*> Evaluate() const;
+
+    /**
+     * \return Messages of the expression computed so far by its shared
+     *         stream; zero for ratio leaves.
+     */
+    std::size_t Computed() const;
+
+    /**
+     * \return Do both expressions refer to the same node?
+     */
+    bool operator==(const Expression& other) const;
+    bool operator!=(const Expression& other) const;
+
+ private:
+
+    friend class Graph;
+    class Node;
+    class Reader;
+
+    // Takes over a reference to node.
+    explicit Expression(Node* node);
+
+    Node* node_;
+};
+
+/**
+ * Hash-consed graph of expressions.
+ * Strategies own their inputs, so expressions built from numbers are
+ * trees, and a subexpression that appears more than once is computed
+ * once per appearance. A graph interns its nodes instead: building a
+ * ratio that is already in the graph, or an operation with the same
+ * coefficients over the same inputs, gives back the node that already
+ * exists. So expressions with shared subexpressions are directed acyclic
+ * graphs, whose nodes are each computed once.
+ *
+ * Coefficients are reduced by their common factor and their sign is fixed
+ * before interning, so that equivalent forms of an operation are one node;
+ * commutative operations are interned regardless of operand order.
+ *
+ * Nodes are reference counted, and leave the graph when no expression
+ * refers to them anymore.
+ *
+ * Nodes, and the numbers that evaluate them, are allocated from the memory
+ * resource of the graph.
+ * \see Expression, Tee
+ */
+class Graph
+{
+ public:
+
+    Graph(const Graph&) = delete;
+    Graph& operator=(const Graph&) = delete;
+    Graph(Graph&&) = delete;
+    Graph& operator=(Graph&&) = delete;
+
+    /**
+     * \param[in] resource Memory resource of the nodes of the graph.
+     */
+    explicit Graph(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~Graph();
+
+    /**
+     * \return Leaf for \f$\frac{n}{d}\f$.
+     * \throws UndefinedRatioError if d is zero.
+     */
+    Expression Ratio(int n, int d);
+
+    /**
+     * \return Node for \f$\frac{n_1 x + n_0}{d_1 x + d_0}\f$.
+     * \pre x belongs to this graph.
+     * \throws UndefinedRatioError if d1 and d0 are zero.
+     * \see strategy::Homography
+     */
+    Expression Homography(const Expression& x, int n1, int n0, int d1, int d0);
+
+    /**
+     * \return Node for
+     * \f$\frac{n_{11}xy + n_{10}x + n_{01}y + n_{00}}{d_{11}xy + d_{10}x + d_{01}y + d_{00}}\f$.
+     * \pre x and y belong to this graph.
+     * \throws UndefinedRatioError if all denominator coefficients are zero.
+     * \see strategy::Bihomography
+     */
+    Expression Bihomography(const Expression& x, const Expression& y,
+                            int n11, int n10, int n01, int n00, int d11, int d10, int d01, int d00);
+
+    /**
+     * \return Node for \f$x+y\f$.
+     */
+    Expression Sum(const Expression& x, const Expression& y);
+
+    /**
+     * \return Node for \f$x-y\f$.
+     */
+    Expression Difference(const Expression& x, const Expression& y);
+
+    /**
+     * \return Node for \f$xy\f$.
+     */
+    Expression Product(const Expression& x, const Expression& y);
+
+    /**
+     * \return Node for \f$x/y\f$.
+     */
+    Expression Quotient(const Expression& x, const Expression& y);
+
+    /**
+     * \return Number of nodes in the graph.
+     */
+    std::size_t Size() const;
+
+ private:
+
+    enum class Kind { Ratio, Homography, Bihomography };
+
+    /**
+     * Identity of a node: its operation, inputs and coefficients.
+     */
+    struct Key
+    {
+        Kind kind;
+        Expression::Node* x;
+        Expression::Node* y;
+        int c[8];
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    friend class Expression::Node;
+
+    Expression Intern(const Key& key);
+    void Forget(const Key& key);
+
+    std::pmr::memory_resource* resource_;
+    std::unordered_map<Key, Expression::Node*, KeyHash> nodes_;
+    // Orders the operands of commutative operations.
+    std::uint64_t next_id_;
+};
+
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_EXPRESSION_HPP_
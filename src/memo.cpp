@@ -0,0 +1,134 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <iterator>
+
+#include "number.hpp"
+#include "protocol/protocol.hpp"
+#include "raise.hpp"
+#include "strategy/strategy.hpp"
+#include "strategy/unavailable_error.hpp"
+#include "strategy/zero.hpp"
+
+#include "memo.hpp"
+
+#include "tracelog.h"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Strategy;
+
+namespace deepnum
+{
+namespace clarith
+{
+
+/**
+ * Replays the messages recorded by a Memo, recording more on demand.
+ */
+class Memo::Cursor : public Strategy
+{
+ public:
+
+    explicit Cursor(Memo* memo)
+            : memo_(memo)
+    {
+        tracelog(memo);
+    }
+
+    bool Egest(Protocol* message) override
+    {
+        if (!memo_->Fill(position_ + 1))
+        {
+            return false;
+        }
+        *message = memo_->cache_[position_++];
+        return true;
+    }
+
+    std::size_t EgestMany(Protocol* out, std::size_t max) override
+    {
+        memo_->Fill(position_ + max);
+        std::size_t count = memo_->cache_.Read(position_, out, max);
+        position_ += count;
+        return count;
+    }
+
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override
+    {
+        if (memo_->x_ || position_ != memo_->cache_.Size())
+        {
+            Raise<strategy::UnavailableError>();
+        }
+        return new (resource) strategy::Zero();
+    }
+
+ private:
+
+    Memo* memo_;
+    std::size_t position_ { 0 };
+};
+
+Memo::Memo(Number* x)
+        : x_(x),
+        resource_(GetResource(x))
+{
+    tracelog(x);
+}
+
+Memo::~Memo()
+{
+    tracelog("");
+    delete x_;
+}
+
+Number* Memo::NewCursor()
+{
+    return new (resource_) Number(new (resource_) Cursor(this));
+}
+
+bool Memo::Fill(std::size_t size)
+{
+    Protocol block[64];
+    while (x_ && cache_.Size() < size)
+    {
+        std::size_t count = x_->EgestMany(block, std::min(size - cache_.Size(), std::size(block)));
+        tracelog("recording " << count << " messages from " << x_);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            cache_.Append(block[i]);
+        }
+        if (cache_.IsTerminated())
+        {
+            tracelog(x_ << " completely recorded");
+            delete x_;
+            x_ = nullptr;
+        }
+    }
+    return cache_.Size() >= size;
+}
+
+const protocol::Buffer& Memo::Cache() const
+{
+    return cache_;
+}
+
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_MEMO_HPP_
+#define SRC_MEMO_HPP_
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <gsl/gsl>
+
+#include "allocatable.hpp"
+#include "protocol/buffer.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+
+class Number;
+
+/**
+ * Memoized number, that can be read any number of times.
+ * Reading a Number consumes it. A Memo records every message egested by
+ * its number in a packed sequence, and hands out cursors: independent
+ * numbers that replay the recorded messages, and only drive the memoized
+ * number for messages past the recorded ones.
+ * So a value can be compared against many others without building its
+ * expression graph again each time.
+ *
+ * Once the memoized number is completely recorded, it is released.
+ * Cursors are allocated from the memory resource of the memoized number.
+ * \see Number, Util::Compare
+ */
+class Memo : public Allocatable
+{
+ public:
+
+    Memo(const Memo&) = delete;
+    Memo& operator=(const Memo&) = delete;
+    Memo(Memo&&) = delete;
+    Memo& operator=(Memo&&) = delete;
+
+    ~Memo();
+
+    /**
+     * \param[in] x Number to memoize.
+     * \pre x not null, and dynamically allocated.
+     */
+    explicit Memo(gsl::owner<Number*> x);
+
+    /**
+     * Number that reads the memoized number from its first message.
+     * Cursors must not outlive their memo.
+     * \return New cursor.
+     */
+    gsl::owner<Number*> NewCursor();
+
+    /**
+     * Records messages of the memoized number.
+     * \param[in] size Number of messages wanted.
+     * \return Are there at least size messages recorded?
+     *         false if the memoized number has ended before.
+     */
+    bool Fill(std::size_t size);
+
+    /**
+     * \return Messages recorded so far.
+     */
+    const protocol::Buffer& Cache() const;
+
+ private:
+
+    class Cursor;
+
+    // Null once completely recorded.
+    Number* x_;
+    // Resource of x, that outlives it.
+    std::pmr::memory_resource* resource_;
+    protocol::Buffer cache_;
+};
+
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_MEMO_HPP_
@@ -18,8 +18,10 @@
  * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
  */
 
+#include <type_traits>
+#include <utility>
+
 #include "protocol/protocol.hpp"
-#include "strategy/exhaustion_error.hpp"
 #include "strategy/strategy.hpp"
 
 #include "number.hpp"
@@ -27,48 +29,219 @@
 #include "tracelog.h"
 
 using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::BigRatio;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+using deepnum::clarith::strategy::Ratio128;
+using deepnum::clarith::strategy::Ratio64;
 using deepnum::clarith::strategy::Strategy;
-using deepnum::clarith::strategy::ExhaustionError;
+using deepnum::clarith::strategy::Zero;
 
 namespace deepnum
 {
 namespace clarith
 {
 
+namespace
+{
+
+// Alternative indexes of Number::Strategies, for dispatching with a switch.
+enum
+{
+    kPointer,
+    kZero,
+    kRatio,
+    kRatio64,
+    kRatio128,
+    kBigRatio,
+    kHomography,
+    kPlayback,
+};
+
+}  // namespace
+
 Number::Number(gsl::owner<strategy::Strategy*> strategy)
-        : strategy_(strategy)
+        : strategy_(std::in_place_type<Strategy*>, strategy)
+{
+    tracelog("strategy " << strategy);
+}
+
+Number::Number(Number&& other) noexcept
+        : strategy_(std::move(other.strategy_))
+#if NUMBER_SANITY_CHECK
+        , watcher_(std::move(other.watcher_))
+#endif
+{
+    tracelog(&other);
+    // A strategy held by pointer now belongs here.
+    other.strategy_.emplace<kZero>();
+#if NUMBER_SANITY_CHECK
+    // The moved-from number starts over as zero.
+    other.watcher_ = protocol::Watcher {};
+#endif
+}
+
+Number& Number::operator=(Number&& other) noexcept
 {
-    tracelog("strategy " << strategy_);
+    tracelog(&other);
+    if (this == &other)
+    {
+        return *this;
+    }
+    if (strategy_.index() == kPointer)
+    {
+        delete *std::get_if<kPointer>(&strategy_);
+    }
+    std::visit([this](auto& strategy) {
+        strategy_.emplace<std::decay_t<decltype(strategy)>>(std::move(strategy));
+    }, other.strategy_);
+    other.strategy_.emplace<kZero>();
+#if NUMBER_SANITY_CHECK
+    watcher_ = std::move(other.watcher_);
+    other.watcher_ = protocol::Watcher {};
+#endif
+    return *this;
 }
 
 Number::~Number()
 {
     tracelog("");
-    delete strategy_;
+    if (strategy_.index() == kPointer)
+    {
+        delete *std::get_if<kPointer>(&strategy_);
+    }
 }
 
 Protocol Number::Egest()
 {
-    tracelog("querying " << strategy_);
-    try
+    tracelog("querying " << GetStrategy());
+    Protocol answer;
+    while (!EgestFromStrategy(&answer))
     {
-        Protocol answer = strategy_->Egest();
-        tracelog("forwarding " << answer << " from " << strategy_);
+        tracelog(GetStrategy() << " exhausted");
+        ReplaceStrategy();
+        tracelog("new strategy " << GetStrategy());
+    }
+    tracelog("forwarding " << answer << " from " << GetStrategy());
 #if NUMBER_SANITY_CHECK
-        return watcher_.Watch(answer);
+    return watcher_.Watch(answer);
 #else
-        return answer;
+    return answer;
 #endif
+}
+
+bool Number::EgestFromStrategy(Protocol* message)
+{
+    static_assert(std::is_same_v<std::variant_alternative_t<kPointer, Strategies>, Strategy*>
+            && std::is_same_v<std::variant_alternative_t<kZero, Strategies>, Zero>
+            && std::is_same_v<std::variant_alternative_t<kRatio, Strategies>, Ratio>
+            && std::is_same_v<std::variant_alternative_t<kRatio64, Strategies>, Ratio64>
+            && std::is_same_v<std::variant_alternative_t<kRatio128, Strategies>, Ratio128>
+            && std::is_same_v<std::variant_alternative_t<kBigRatio, Strategies>, BigRatio>
+            && std::is_same_v<std::variant_alternative_t<kHomography, Strategies>, Homography>
+            && std::is_same_v<std::variant_alternative_t<kPlayback, Strategies>, Playback>,
+            "strategy indexes out of sync");
+    // Qualified calls bypass virtual dispatch for strategies stored in place.
+    switch (strategy_.index())
+    {
+        case kZero:
+            return std::get_if<kZero>(&strategy_)->Zero::Egest(message);
+        case kRatio:
+            return std::get_if<kRatio>(&strategy_)->Ratio::Egest(message);
+        case kRatio64:
+            return std::get_if<kRatio64>(&strategy_)->Ratio64::Egest(message);
+        case kRatio128:
+            return std::get_if<kRatio128>(&strategy_)->Ratio128::Egest(message);
+        case kBigRatio:
+            return std::get_if<kBigRatio>(&strategy_)->BigRatio::Egest(message);
+        case kHomography:
+            return std::get_if<kHomography>(&strategy_)->Homography::Egest(message);
+        case kPlayback:
+            return std::get_if<kPlayback>(&strategy_)->Playback::Egest(message);
+        default:
+            return (*std::get_if<kPointer>(&strategy_))->Egest(message);
     }
-    catch (ExhaustionError)
+}
+
+std::size_t Number::EgestMany(Protocol* out, std::size_t max)
+{
+    std::size_t count = 0;
+    while (count < max)
     {
-        tracelog(strategy_ << " exhausted");
-        Strategy* aux = strategy_;
-        strategy_ = strategy_->GetNewStrategy();
-        tracelog("new strategy " << strategy_);
-        delete aux;
+        tracelog("querying " << GetStrategy());
+        std::size_t egested = EgestManyFromStrategy(out + count, max - count);
+        if (!egested)
+        {
+            tracelog(GetStrategy() << " exhausted");
+            ReplaceStrategy();
+            tracelog("new strategy " << GetStrategy());
+            continue;
+        }
+        tracelog("forwarding " << egested << " messages from " << GetStrategy());
+        for (std::size_t end = count + egested; count < end;)
+        {
+#if NUMBER_SANITY_CHECK
+            watcher_.Watch(out[count]);
+#endif
+            if (out[count++] == Protocol::End)
+            {
+                return count;
+            }
+        }
     }
-    return Egest();
+    return count;
+}
+
+std::size_t Number::EgestManyFromStrategy(Protocol* out, std::size_t max)
+{
+    switch (strategy_.index())
+    {
+        case kZero:
+            return std::get_if<kZero>(&strategy_)->Zero::EgestMany(out, max);
+        case kRatio:
+            return std::get_if<kRatio>(&strategy_)->Ratio::EgestMany(out, max);
+        case kRatio64:
+            return std::get_if<kRatio64>(&strategy_)->Ratio64::EgestMany(out, max);
+        case kRatio128:
+            return std::get_if<kRatio128>(&strategy_)->Ratio128::EgestMany(out, max);
+        case kBigRatio:
+            return std::get_if<kBigRatio>(&strategy_)->BigRatio::EgestMany(out, max);
+        case kHomography:
+            return std::get_if<kHomography>(&strategy_)->Homography::EgestMany(out, max);
+        case kPlayback:
+            return std::get_if<kPlayback>(&strategy_)->Playback::EgestMany(out, max);
+        default:
+            return (*std::get_if<kPointer>(&strategy_))->EgestMany(out, max);
+    }
+}
+
+void Number::ReplaceStrategy()
+{
+    Strategy* strategy = GetStrategy();
+    // Strategies held by pointer are deleted once replaced; they are kept,
+    // and raise again when read, if their successor cannot be built.
+    Strategy* aux = strategy_.index() == kPointer ? strategy : nullptr;
+    if (!strategy->SucceedInto(this))
+    {
+        strategy_.emplace<kPointer>(strategy->GetNewStrategy(
+                aux ? GetResource(aux) : std::pmr::get_default_resource()));
+    }
+    delete aux;
+}
+
+Strategy* Number::GetStrategy()
+{
+    return std::visit([](auto& s) -> Strategy* {
+        if constexpr (std::is_pointer_v<std::decay_t<decltype(s)>>)
+        {
+            return s;
+        }
+        else
+        {
+            return &s;
+        }
+    }, strategy_);
 }
 
 }  // namespace clarith
@@ -23,8 +23,18 @@
 
 #include <config.h>
 
+#include <cstddef>
+#include <utility>
+#include <variant>
+
 #include <gsl/gsl>
 
+#include "allocatable.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "strategy/zero.hpp"
+
 #if NUMBER_SANITY_CHECK
 #include "protocol/watcher.hpp"
 #endif
@@ -39,23 +49,57 @@ namespace protocol
 enum class Protocol;
 }  // namespace protocol
 
-namespace strategy
-{
-class Strategy;
-}  // namespace strategy
-
 /**
  * Numerical value in continued logarithm representation.
+ *
+ * The library strategies (strategy::Zero, strategy::Ratio and its wider
+ * variants, strategy::Homography and strategy::Playback) can be stored inside the
+ * Number instance itself; they are then dispatched without virtual calls,
+ * and replaced in place when exhausted.
+ * The successor of a library strategy is built in place as well when
+ * the exhausted strategy is held by pointer
+ * (see strategy::Strategy::SucceedInto).
+ * Any other strategy is held by pointer and dispatched through
+ * the strategy::Strategy interface.
+ *
+ * Numbers move, but do not copy: each one is a stream of messages that is
+ * consumed as it is read. So a number of a library strategy can live on
+ * the stack or in a container without any allocation of its own.
+ * Numbers that are inputs of strategies, though, are owned and deleted by
+ * them, and must be dynamically allocated (move a number off the stack
+ * with `new Number(std::move(number))`).
+ *
+ * A Number is as large as its largest in place strategy, strategy::Homography,
+ * whose coefficients may be arbitrary precision integers: 224 bytes on x86-64
+ * (strategy::Playback, the next largest, takes 96). Homographies are
+ * the bulk of most expression graphs, and each of them stored in place
+ * saves a separate allocation of over 200 bytes, plus the pointer to it;
+ * numbers of smaller strategies pay for that room.
+ * \see Allocatable
  */
-class Number
+class Number : public Allocatable
 {
  public:
 
     ~Number();
     Number(const Number&) = delete;
     Number& operator=(const Number&) = delete;
-    Number(Number&&) = delete;
-    Number& operator=(Number&&) = delete;
+
+    /**
+     * Numbers are values that can be moved, for instance in and out of
+     * containers, along with the strategy they hold.
+     * The moved-from number is left as zero.
+     * \param[in] other Number to move.
+     */
+    Number(Number&& other) noexcept;
+
+    /**
+     * Moves a number in place of this one, whose strategy is destroyed.
+     * The moved-from number is left as zero.
+     * \param[in] other Number to move.
+     * \return This number.
+     */
+    Number& operator=(Number&& other) noexcept;
 
     /**
      * A Number is defined by means of a strategy (that may combine other
@@ -65,6 +109,20 @@ class Number
      */
     explicit Number(gsl::owner<strategy::Strategy*> strategy);
 
+    /**
+     * A Number defined by a library strategy stored in place.
+     * Usage example: `Number(std::in_place_type<strategy::Ratio>, 1, 3)`.
+     * \param[in] type Strategy type; one of strategy::Zero, strategy::Ratio,
+     *                 strategy::Ratio64, strategy::Ratio128, strategy::BigRatio,
+     *                 strategy::Homography or strategy::Playback.
+     * \param[in] args Strategy constructor arguments.
+     */
+    template <typename S, typename... Args>
+    explicit Number(std::in_place_type_t<S> type, Args&&... args)
+            : strategy_(type, std::forward<Args>(args)...)
+    {
+    }
+
     /**
      * Extract Number information.
      * Takes out the next piece of information from the Number instance, which
@@ -73,13 +131,75 @@ class Number
      */
     protocol::Protocol Egest();
 
+    /**
+     * Extract several pieces of Number information at once.
+     * Takes out up to max messages from the Number instance; extraction
+     * stops after protocol::Protocol::End.
+     * \param[out] out Next continued logarithm protocol messages.
+     * \param[in] max Maximum number of messages to extract.
+     * \return Number of extracted messages; less than max only if the last
+     *         of them is protocol::Protocol::End.
+     * \see Egest
+     */
+    std::size_t EgestMany(protocol::Protocol* out, std::size_t max);
+
  private:
-    strategy::Strategy* strategy_;
+
+    /**
+     * Strategy storage.
+     * The first alternative holds strategies by pointer.
+     */
+    using Strategies = std::variant<
+            strategy::Strategy*,
+            strategy::Zero,
+            strategy::Ratio,
+            strategy::Ratio64,
+            strategy::Ratio128,
+            strategy::BigRatio,
+            strategy::Homography,
+            strategy::Playback>;
+
+    // Looks into its input to fold nested homographies.
+    friend class strategy::Homography;
+    // Stores successors in place.
+    friend class strategy::Strategy;
+
+    bool EgestFromStrategy(protocol::Protocol* message);
+    std::size_t EgestManyFromStrategy(protocol::Protocol* out, std::size_t max);
+    void ReplaceStrategy();
+
+    /**
+     * Replaces the strategy by a new one of type S, stored in place.
+     * The new strategy is built aside before the current one is destroyed,
+     * so that the current one is kept, and raises again when read, if
+     * building fails (eg: on an undefined result).
+     * \param[in] args Constructor arguments, that may refer to the current strategy.
+     */
+    template <typename S, typename... Args>
+    void Succeed(Args&&... args)
+    {
+        Strategies next(std::in_place_type<S>, std::forward<Args>(args)...);
+        strategy_.template emplace<S>(std::move(*std::get_if<S>(&next)));
+    }
+
+    strategy::Strategy* GetStrategy();
+
+    Strategies strategy_;
 #if NUMBER_SANITY_CHECK
     protocol::Watcher watcher_;
 #endif
 };
 
+namespace strategy
+{
+
+template <typename S, typename... Args>
+void Strategy::Succeed(Number* number, Args&&... args)
+{
+    number->Succeed<S>(std::forward<Args>(args)...);
+}
+
+}  // namespace strategy
 }  // namespace clarith
 }  // namespace deepnum
 
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+
+#include "raise.hpp"
+#include "violation_error.hpp"
+
+#include "buffer.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace protocol
+{
+
+void Buffer::Append(Protocol message)
+{
+    if (terminated_)
+    {
+        Raise<ViolationError>("forbidden non final '0'");
+    }
+    if (!size_)
+    {
+        head_ = message;
+        terminated_ = message == Protocol::End;
+        ++size_;
+        return;
+    }
+    switch (message)
+    {
+        case Protocol::End:
+            if ((*this)[size_ - 1] == Protocol::Amplify)
+            {
+                Raise<ViolationError>("forbidden '20' sequence");
+            }
+            terminated_ = true;
+            break;
+        case Protocol::Amplify:
+        case Protocol::Uncover:
+        {
+            std::size_t bit = size_ - 1;
+            if (bit % kWordBits == 0)
+            {
+                tail_.push_back(0);
+            }
+            if (message == Protocol::Uncover)
+            {
+                tail_.back() |= Word(1) << (bit % kWordBits);
+            }
+            break;
+        }
+        case Protocol::Turn:
+            Raise<ViolationError>("forbidden non initial '/'");
+        case Protocol::Reflect:
+            Raise<ViolationError>("forbidden non initial '-'");
+        case Protocol::Ground:
+            Raise<ViolationError>("forbidden non initial '-/'");
+    }
+    ++size_;
+}
+
+std::size_t Buffer::Size() const
+{
+    return size_;
+}
+
+bool Buffer::IsTerminated() const
+{
+    return terminated_;
+}
+
+Protocol Buffer::operator[](std::size_t index) const
+{
+    if (!index)
+    {
+        return head_;
+    }
+    if (terminated_ && index == size_ - 1)
+    {
+        return Protocol::End;
+    }
+    std::size_t bit = index - 1;
+    return tail_[bit / kWordBits] >> (bit % kWordBits) & 1 ? Protocol::Uncover : Protocol::Amplify;
+}
+
+std::size_t Buffer::Read(std::size_t index, Protocol* out, std::size_t max) const
+{
+    std::size_t count = std::min(max, size_ - index);
+    std::size_t stop = index + count;
+    if (index == 0 && index < stop)
+    {
+        *out++ = head_;
+        ++index;
+    }
+    std::size_t tail_stop = terminated_ ? std::min(stop, size_ - 1) : stop;
+    while (index < tail_stop)
+    {
+        // Decode one word at a time.
+        std::size_t bit = index - 1;
+        std::size_t run = std::min(tail_stop - index, kWordBits - bit % kWordBits);
+        Word word = tail_[bit / kWordBits] >> (bit % kWordBits);
+        for (std::size_t i = 0; i < run; ++i, word >>= 1)
+        {
+            *out++ = word & 1 ? Protocol::Uncover : Protocol::Amplify;
+        }
+        index += run;
+    }
+    if (index < stop)
+    {
+        *out = Protocol::End;
+    }
+    return count;
+}
+
+Buffer::Iterator Buffer::begin() const
+{
+    return Iterator(this, 0);
+}
+
+Buffer::Iterator Buffer::end() const
+{
+    return Iterator(this, size_);
+}
+
+}  // namespace protocol
+}  // namespace clarith
+}  // namespace deepnum
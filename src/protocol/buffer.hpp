@@ -0,0 +1,151 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_PROTOCOL_BUFFER_HPP_
+#define SRC_PROTOCOL_BUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "protocol.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace protocol
+{
+
+/**
+ * Packed Protocol sequence.
+ *
+ * Only the first message of a valid sequence can be Protocol::Turn,
+ * Protocol::Reflect or Protocol::Ground, and Protocol::End can only be the
+ * last one.
+ * The first message is therefore kept apart, the final Protocol::End is
+ * kept as a flag, and every other message takes a single bit
+ * (Protocol::Amplify or Protocol::Uncover).
+ *
+ * Messages are validated as they are appended, so that a Buffer always
+ * holds a valid (possibly unfinished) sequence. Replaying it does not need
+ * any further checking.
+ * \see Watcher, strategy::Playback
+ */
+class Buffer
+{
+ public:
+
+    /**
+     * Read only forward iterator over the messages of a Buffer.
+     */
+    class Iterator
+    {
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Protocol;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Protocol*;
+        using reference = Protocol;
+
+        Iterator(const Buffer* buffer, std::size_t index)
+                : buffer_(buffer), index_(index) {}
+        Protocol operator*() const { return (*buffer_)[index_]; }
+        Iterator& operator++() { ++index_; return *this; }
+        Iterator operator++(int) { Iterator aux = *this; ++index_; return aux; }
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+     private:
+        const Buffer* buffer_;
+        std::size_t index_;
+    };
+
+    Buffer() = default;
+
+    /**
+     * Build from a sequence of messages, such as a contiguous array.
+     * \param[in] first Start of sequence.
+     * \param[in] last End of sequence.
+     * \throw ViolationError
+     */
+    template <typename InputIterator>
+    Buffer(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+        {
+            Append(*first);
+        }
+    }
+
+    /**
+     * Append a message to the end of the sequence.
+     * \param[in] message Next message of the sequence.
+     * \throw ViolationError
+     */
+    void Append(Protocol message);
+
+    /**
+     * \return Number of messages in the sequence.
+     */
+    std::size_t Size() const;
+
+    /**
+     * \return Does the sequence end with Protocol::End?
+     */
+    bool IsTerminated() const;
+
+    /**
+     * Random access to messages.
+     * \param[in] index Message position.
+     * \pre index is lesser than Size().
+     * \return Message at position index.
+     */
+    Protocol operator[](std::size_t index) const;
+
+    /**
+     * Copy consecutive messages out.
+     * \param[in] index Position of first message.
+     * \param[out] out Copied messages.
+     * \param[in] max Maximum number of messages to copy.
+     * \pre index is not greater than Size().
+     * \return Number of copied messages.
+     */
+    std::size_t Read(std::size_t index, Protocol* out, std::size_t max) const;
+
+    Iterator begin() const;
+    Iterator end() const;
+
+ private:
+    using Word = std::uint64_t;
+    static constexpr std::size_t kWordBits = 64;
+
+    std::vector<Word> tail_;
+    std::size_t size_ { 0 };
+    Protocol head_ { Protocol::End };
+    bool terminated_ { false };
+};
+
+}  // namespace protocol
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_PROTOCOL_BUFFER_HPP_
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <array>
+#include <cstddef>
+
+#include "matrix.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace protocol
+{
+
+namespace
+{
+
+// Runs of length l start at index 2^l-1 of the table.
+constexpr std::size_t kTableSize = (std::size_t(2) << kMaxRun) - 1;
+
+constexpr std::array<Matrix, kTableSize> BuildTable()
+{
+    std::array<Matrix, kTableSize> table {};
+    table[0] = Matrix { 1, 0, 0, 1 };
+    for (std::size_t length = 1; length <= kMaxRun; ++length)
+    {
+        std::size_t shorter = (std::size_t(1) << (length - 1)) - 1;
+        std::size_t start = (std::size_t(1) << length) - 1;
+        for (std::size_t bits = 0; bits < std::size_t(1) << length; ++bits)
+        {
+            // Append the last message of the run to its shorter prefix.
+            std::size_t prefix = bits & ((std::size_t(1) << (length - 1)) - 1);
+            Protocol last = bits >> (length - 1) ? Protocol::Uncover : Protocol::Amplify;
+            table[start + bits] = table[shorter + prefix] * InputMatrix(last);
+        }
+    }
+    return table;
+}
+
+constexpr std::array<Matrix, kTableSize> kTable = BuildTable();
+
+}  // namespace
+
+const Matrix& InputMatrix(unsigned int bits, unsigned int length)
+{
+    return kTable[(std::size_t(1) << length) - 1 + bits];
+}
+
+Matrix InputMatrix(const Protocol* block, std::size_t count, bool* end)
+{
+    std::size_t i = 0;
+    Matrix head { 1, 0, 0, 1 };
+    if (count && block[0] != Protocol::End && block[0] != Protocol::Amplify && block[0] != Protocol::Uncover)
+    {
+        head = InputMatrix(block[0]);
+        ++i;
+    }
+    unsigned int bits = 0;
+    unsigned int length = 0;
+    for (; i < count && block[i] != Protocol::End; ++i, ++length)
+    {
+        if (block[i] == Protocol::Uncover)
+        {
+            bits |= 1u << length;
+        }
+    }
+    *end = i < count;
+    return head * InputMatrix(bits, length);
+}
+
+}  // namespace protocol
+}  // namespace clarith
+}  // namespace deepnum
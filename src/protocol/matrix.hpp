@@ -0,0 +1,124 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_PROTOCOL_MATRIX_HPP_
+#define SRC_PROTOCOL_MATRIX_HPP_
+
+#include <cstddef>
+
+#include "protocol.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace protocol
+{
+
+/**
+ * Integer 2x2 matrix \f$\begin{pmatrix}a & b\\ c & d\end{pmatrix}\f$.
+ * Stands for the homographic transformation \f$x \mapsto \frac{ax+b}{cx+d}\f$;
+ * composing transformations is multiplying their matrices.
+ */
+struct Matrix
+{
+    int a, b, c, d;
+};
+
+constexpr Matrix operator*(const Matrix& m, const Matrix& n)
+{
+    return Matrix {
+        m.a * n.a + m.b * n.c, m.a * n.b + m.b * n.d,
+        m.c * n.a + m.d * n.c, m.c * n.b + m.d * n.d,
+    };
+}
+
+constexpr bool operator==(const Matrix& m, const Matrix& n)
+{
+    return m.a == n.a && m.b == n.b && m.c == n.c && m.d == n.d;
+}
+
+/**
+ * Input substitution of a message.
+ * When a number \f$x_1\f$ egests a message, it becomes \f$x_2\f$ such that
+ * \f$x_1 = M(x_2)\f$; this is M.
+ * \param[in] message A message other than Protocol::End.
+ * \return Substitution matrix, up to a scale factor.
+ */
+constexpr Matrix InputMatrix(Protocol message)
+{
+    switch (message)
+    {
+        case Protocol::Amplify:
+            // x1 = x2/2
+            return Matrix { 1, 0, 0, 2 };
+        case Protocol::Uncover:
+            // x1 = 1/(x2+1)
+            return Matrix { 0, 1, 1, 1 };
+        case Protocol::Turn:
+            // x1 = 1/x2
+            return Matrix { 0, 1, 1, 0 };
+        case Protocol::Reflect:
+            // x1 = -x2
+            return Matrix { -1, 0, 0, 1 };
+        case Protocol::Ground:
+            // x1 = -1/x2
+            return Matrix { 0, -1, 1, 0 };
+        default:
+            return Matrix { 1, 0, 0, 1 };
+    }
+}
+
+/**
+ * Longest run of Protocol::Amplify and Protocol::Uncover messages
+ * whose input substitution is tabulated.
+ */
+constexpr unsigned int kMaxRun = 8;
+
+/**
+ * Input substitution of a run of Protocol::Amplify and Protocol::Uncover
+ * messages, taken from a precomputed table.
+ * \param[in] bits Bit i tells whether message i of the run is Protocol::Uncover
+ *                 (set) or Protocol::Amplify (clear), as in Buffer.
+ * \param[in] length Number of messages in the run.
+ * \pre length is not greater than kMaxRun.
+ * \return Product of the substitution matrices of the run, in order.
+ */
+const Matrix& InputMatrix(unsigned int bits, unsigned int length);
+
+/**
+ * Input substitution of a block of messages, as egested by a number:
+ * an optional Protocol::Turn, Protocol::Reflect or Protocol::Ground
+ * followed by Protocol::Amplify and Protocol::Uncover messages,
+ * possibly up to Protocol::End.
+ * \param[in] block Messages.
+ * \param[in] count Number of messages.
+ * \param[out] end Set to whether the block holds Protocol::End.
+ * \pre count is not greater than kMaxRun.
+ * \return Product of the substitution matrices of the messages before
+ *         Protocol::End, in order.
+ */
+Matrix InputMatrix(const Protocol* block, std::size_t count, bool* end);
+
+}  // namespace protocol
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_PROTOCOL_MATRIX_HPP_
@@ -22,6 +22,7 @@
 
 #if TRACE
 #include <stdexcept>
+#include "raise.hpp"
 #endif  // TRACE
 
 namespace deepnum
@@ -55,7 +56,7 @@ std::ostream& operator<<(std::ostream& os, const Protocol& message)
             os << "Ground";
             break;
         default:
-            throw std::logic_error("unknown Protocol message");
+            Raise<std::logic_error>("unknown Protocol message");
     }
     return os;
 }
@@ -21,6 +21,7 @@
 #include "watcher.hpp"
 
 #include "protocol.hpp"
+#include "raise.hpp"
 #include "violation_error.hpp"
 
 namespace deepnum
@@ -40,7 +41,7 @@ Protocol Watcher::Watch(Protocol message)
     }
     if (previous_ == Protocol::End && message != Protocol::End)
     {
-        throw ViolationError("forbidden non final '0'");
+        Raise<ViolationError>("forbidden non final '0'");
     }
     switch (message)
     {
@@ -48,15 +49,15 @@ Protocol Watcher::Watch(Protocol message)
             switch (previous_)
             {
                 case Protocol::Amplify:
-                    throw ViolationError("forbidden '20' sequence");
+                    Raise<ViolationError>("forbidden '20' sequence");
             }
             break;
         case Protocol::Turn:
-            throw ViolationError("forbidden non initial '/'");
+            Raise<ViolationError>("forbidden non initial '/'");
         case Protocol::Reflect:
-            throw ViolationError("forbidden non initial '-'");
+            Raise<ViolationError>("forbidden non initial '-'");
         case Protocol::Ground:
-            throw ViolationError("forbidden non initial '-/'");
+            Raise<ViolationError>("forbidden non initial '-/'");
 
     }
     previous_ = message;
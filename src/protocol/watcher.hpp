@@ -43,8 +43,8 @@ class Watcher
     ~Watcher() = default;
     Watcher(const Watcher&) = delete;
     Watcher& operator=(const Watcher&) = delete;
-    Watcher(Watcher&&) = delete;
-    Watcher& operator=(Watcher&&) = delete;
+    Watcher(Watcher&&) = default;
+    Watcher& operator=(Watcher&&) = default;
 
     /**
      * Check one more message of a Protocol sequence for violation errors.
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2018 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_RAISE_HPP_
+#define SRC_RAISE_HPP_
+
+#include <cstdlib>
+#include <utility>
+
+namespace deepnum
+{
+namespace clarith
+{
+
+/**
+ * Report an error condition.
+ * Throws an exception of type E.
+ * When the library is built without exception support (eg: -fno-exceptions)
+ * the program is aborted instead.
+ * \param[in] args Exception constructor arguments.
+ */
+template <typename E, typename... Args>
+[[noreturn]] void Raise(Args&&... args)
+{
+#if __cpp_exceptions
+    throw E(std::forward<Args>(args)...);
+#else
+    std::abort();
+#endif
+}
+
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_RAISE_HPP_
@@ -1,5 +1,5 @@
 /*
- * Copyright 2018 Rafael Lorandi <coolparadox@gmail.com>
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
  *
  * This file is part of dn-clarith, a library for performing arithmetic
  * in continued logarithm representation.
@@ -18,20 +18,29 @@
  * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
  */
 
-#include "exhaustion_error.hpp"
+#include "statistics.hpp"
 
 namespace deepnum
 {
 namespace clarith
 {
-namespace strategy
+
+namespace
+{
+
+thread_local Statistics statistics {};
+
+}  // namespace
+
+Statistics& Statistics::Current()
 {
+    return statistics;
+}
 
-ExhaustionError::ExhaustionError()
-        : runtime_error("strategy exhaustion")
+void Statistics::Reset()
 {
+    statistics = Statistics {};
 }
 
-}  // namespace strategy
 }  // namespace clarith
 }  // namespace deepnum
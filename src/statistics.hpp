@@ -0,0 +1,89 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_STATISTICS_HPP_
+#define SRC_STATISTICS_HPP_
+
+#include <config.h>
+
+#include <cstdint>
+
+namespace deepnum
+{
+namespace clarith
+{
+
+/**
+ * Library event counters, for profiling.
+ * Counters are kept per thread, and are only updated when the library is
+ * configured with --enable-statistics.
+ */
+struct Statistics
+{
+    /**
+     * Output range tests made by strategy::Homography and
+     * strategy::Bihomography.
+     * Each one takes a few integer comparisons.
+     */
+    std::uint64_t range_tests;
+
+    /**
+     * Coefficient promotions to a wider type made by strategy::Homography
+     * and strategy::Bihomography.
+     */
+    std::uint64_t promotions;
+
+    /**
+     * Coefficient divisions by a common factor made by strategy::Homography
+     * and strategy::Bihomography.
+     */
+    std::uint64_t reductions;
+
+    /**
+     * Nested strategy::Homography instances folded into one.
+     */
+    std::uint64_t compositions;
+
+    /**
+     * strategy::Homography outputs worked out from an input of known value.
+     */
+    std::uint64_t evaluations;
+
+    /**
+     * \return Counters of the calling thread.
+     */
+    static Statistics& Current();
+
+    /**
+     * Zero all counters of the calling thread.
+     */
+    static void Reset();
+};
+
+}  // namespace clarith
+}  // namespace deepnum
+
+#if STATISTICS
+#define statcount(X) (++::deepnum::clarith::Statistics::Current().X)
+#else
+#define statcount(X) ((void) 0)
+#endif  // STATISTICS
+
+#endif  // SRC_STATISTICS_HPP_
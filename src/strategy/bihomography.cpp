@@ -0,0 +1,433 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "arithmetic/checked.hpp"
+#include "number.hpp"
+#include "protocol/matrix.hpp"
+#include "protocol/protocol.hpp"
+#include "raise.hpp"
+#include "statistics.hpp"
+#include "strategy/ratio.hpp"
+#include "strategy/terms.hpp"
+#include "strategy/unavailable_error.hpp"
+#include "strategy/undefined_ratio_error.hpp"
+
+#include "bihomography.hpp"
+
+#include "tracelog.h"
+
+using deepnum::clarith::arithmetic::Add;
+using deepnum::clarith::arithmetic::Integer;
+using deepnum::clarith::arithmetic::Wider;
+using deepnum::clarith::protocol::Protocol;
+
+namespace deepnum
+{
+
+namespace clarith
+{
+
+namespace strategy
+{
+
+namespace
+{
+
+template <typename T>
+int Sign(const T& a)
+{
+    return a > 0 ? 1 : a < 0 ? -1 : 0;
+}
+
+}  // namespace
+
+Bihomography::Bihomography(Number* x, Number* y,
+                           int n11, int n10, int n01, int n00, int d11, int d10, int d01, int d00)
+        : _x { x, false },
+        _y { y, false },
+        _next(&_x),
+        _state(Coefficients<int> { n11, n10, n01, n00, d11, d10, d01, d00 }),
+        _primed(false),
+        _exhausted(false),
+        _has_pole(d11 || d10 || d01),
+        _pole_in_range(true),
+        _constant(false)
+{
+    tracelog(x << " " << y << " " << n11 << " " << n10 << " " << n01 << " " << n00
+             << " " << d11 << " " << d10 << " " << d01 << " " << d00);
+    if (!n11 && !n10 && !n01 && !n00 && !d11 && !d10 && !d01 && !d00)
+    {
+        delete _x.number;
+        delete _y.number;
+        Raise<UndefinedRatioError>();
+    }
+    // Every transform keeps numerator and denominator proportional or not.
+    Coefficients<std::int64_t> c { n11, n10, n01, n00, d11, d10, d01, d00 };
+    std::int64_t* n[] = { &c.n11, &c.n10, &c.n01, &c.n00 };
+    std::int64_t* d[] = { &c.d11, &c.d10, &c.d01, &c.d00 };
+    _constant = Proportional(n, d);
+}
+
+Bihomography::~Bihomography()
+{
+    tracelog("");
+    delete _x.number;
+    delete _y.number;
+}
+
+Bihomography* Bihomography::Sum(Number* x, Number* y)
+{
+    return new (GetResource(x)) Bihomography(x, y, 0, 1, 1, 0, 0, 0, 0, 1);
+}
+
+Bihomography* Bihomography::Difference(Number* x, Number* y)
+{
+    return new (GetResource(x)) Bihomography(x, y, 0, 1, -1, 0, 0, 0, 0, 1);
+}
+
+Bihomography* Bihomography::Product(Number* x, Number* y)
+{
+    return new (GetResource(x)) Bihomography(x, y, 1, 0, 0, 0, 0, 0, 0, 1);
+}
+
+Bihomography* Bihomography::Quotient(Number* x, Number* y)
+{
+    return new (GetResource(x)) Bihomography(x, y, 0, 1, 0, 0, 0, 0, 1, 0);
+}
+
+bool Bihomography::Egest(Protocol* message)
+{
+    return Bihomography::EgestMany(message, 1);
+}
+
+std::size_t Bihomography::EgestMany(Protocol* out, std::size_t max)
+{
+    if (_exhausted)
+    {
+        return 0;
+    }
+    if (!_primed)
+    {
+        _primed = true;
+        // Inputs are completely unknown; make them lie between 0 and 1.
+        if (!Ingest(&_x) || !Ingest(&_y))
+        {
+            return 0;
+        }
+    }
+
+    std::size_t count = 0;
+    while (count < max)
+    {
+
+        Step step = std::visit([&](auto& c) { return EgestMany(&c, out, max, &count); }, _state);
+        switch (step)
+        {
+            case Step::Full:
+                break;
+            case Step::Point:
+                tracelog("output range is a point");
+                _exhausted = true;
+                return count;
+            case Step::NeedInput:
+                if (count)
+                {
+                    // Deliver what is known before asking input for more.
+                    return count;
+                }
+                tracelog("need more input");
+                if (!Ingest(_next))
+                {
+                    return count;
+                }
+                break;
+            case Step::Overflow:
+                MakeRoom();
+                break;
+        }
+
+    }
+    return count;
+
+}
+
+template <typename T>
+Bihomography::Step Bihomography::EgestMany(Coefficients<T>* c, Protocol* out, std::size_t max, std::size_t* count)
+{
+    while (*count < max)
+    {
+        if (_constant && (c->n00 || c->d00))
+        {
+            return Step::Point;
+        }
+        /*
+         * Numerator and denominator at the corners (1, 0), (0, 1) and (1, 1)
+         * of the input range; the corner (0, 0) is n00/d00.
+         */
+        T n10, n01, n11, d10, d01, d11;
+        if (!Add(c->n10, c->n00, &n10) || !Add(c->n01, c->n00, &n01)
+                || !Add(c->n11, n10, &n11) || !Add(n11, c->n01, &n11)
+                || !Add(c->d10, c->d00, &d10) || !Add(c->d01, c->d00, &d01)
+                || !Add(c->d11, d10, &d11) || !Add(d11, c->d01, &d11))
+        {
+            return Step::Overflow;
+        }
+        bool x_spreads;
+        bool y_spreads;
+        /*
+         * Without a pole, the output range lies between the outputs at
+         * the corners. Egesting keeps the denominator clear of roots over
+         * the input range, so it is only checked again after ingestion.
+         */
+        if (_pole_in_range)
+        {
+            const T* corners[] = { &c->d00, &d10, &d01, &d11 };
+            _pole_in_range = HasRootInRange(corners);
+        }
+        if (_pole_in_range)
+        {
+            tracelog("may have a pole in input range");
+            int s00 = Sign(c->d00);
+            int s10 = Sign(d10);
+            int s01 = Sign(d01);
+            int s11 = Sign(d11);
+            x_spreads = s00 != s10 || s01 != s11;
+            y_spreads = s00 != s01 || s10 != s11;
+        }
+        else
+        {
+            statcount(range_tests);
+            Protocol r00 = Classify(c->n00, c->d00);
+            Protocol r10 = Classify(n10, d10);
+            Protocol r01 = Classify(n01, d01);
+            Protocol r11 = Classify(n11, d11);
+            tracelog("output regions at corners are " << r00 << " " << r10 << " " << r01 << " " << r11);
+            if (r00 != Protocol::End && r00 == r10 && r00 == r01 && r00 == r11)
+            {
+                if (!Egest(c, r00))
+                {
+                    return Step::Overflow;
+                }
+                out[(*count)++] = r00;
+                continue;
+            }
+            x_spreads = r00 != r10 || r01 != r11;
+            y_spreads = r00 != r01 || r10 != r11;
+        }
+        // Ingest the input that spreads the output range; take turns on a tie.
+        if (_x.ended || _y.ended)
+        {
+            _next = _x.ended ? &_y : &_x;
+        }
+        else if (x_spreads != y_spreads)
+        {
+            _next = x_spreads ? &_x : &_y;
+        }
+        else
+        {
+            _next = _next == &_x ? &_y : &_x;
+        }
+        return Step::NeedInput;
+    }
+    return Step::Full;
+}
+
+void Bihomography::MakeRoom()
+{
+    bool reduced = std::visit([](auto& c) {
+        decltype(&c.n11) terms[] = { &c.n11, &c.n10, &c.n01, &c.n00, &c.d11, &c.d10, &c.d01, &c.d00 };
+        return ReduceTerms(terms);
+    }, _state);
+    if (reduced)
+    {
+        statcount(reductions);
+        tracelog("coefficients reduced");
+        return;
+    }
+    Promote();
+}
+
+void Bihomography::Promote()
+{
+    statcount(promotions);
+    _state = std::visit([](auto& c) -> State {
+        using T = std::decay_t<decltype(c.n11)>;
+        if constexpr (std::is_same_v<T, Integer>)
+        {
+            Raise<std::logic_error>("arbitrary precision coefficients cannot overflow");
+            return c;
+        }
+        else
+        {
+            using W = typename Wider<T>::type;
+            return Coefficients<W> { W(c.n11), W(c.n10), W(c.n01), W(c.n00), W(c.d11), W(c.d10), W(c.d01), W(c.d00) };
+        }
+    }, _state);
+    tracelog("coefficients promoted to alternative " << _state.index());
+}
+
+template <typename T>
+bool Bihomography::Egest(Coefficients<T>* c, Protocol output)
+{
+    // Work on a copy, so that an overflow leaves coefficients untouched.
+    Coefficients<T> r = *c;
+    T* n[] = { &r.n11, &r.n10, &r.n01, &r.n00 };
+    T* d[] = { &r.d11, &r.d10, &r.d01, &r.d00 };
+    if (!EgestTerms(output, n, d))
+    {
+        return false;
+    }
+    *c = std::move(r);
+    tracelog("egesting " << output << ", new state " << c->n11 << " " << c->n10 << " " << c->n01 << " " << c->n00
+             << " " << c->d11 << " " << c->d10 << " " << c->d01 << " " << c->d00);
+    return true;
+}
+
+Strategy* Bihomography::GetNewStrategy(std::pmr::memory_resource* resource) const
+{
+    return std::visit([resource](const auto& c) -> Strategy* {
+        using Result = typename RatioOf<std::decay_t<decltype(c.n00)>>::type;
+        return new (resource) Result(c.n00, c.d00);
+    }, GetResult());
+}
+
+bool Bihomography::SucceedInto(Number* number) const
+{
+    std::visit([number](const auto& c) {
+        using Result = typename RatioOf<std::decay_t<decltype(c.n00)>>::type;
+        Succeed<Result>(number, c.n00, c.d00);
+    }, GetResult());
+    return true;
+}
+
+const Bihomography::State& Bihomography::GetResult() const
+{
+    if (!_exhausted)
+    {
+        Raise<UnavailableError>();
+    }
+    return _state;
+}
+
+bool Bihomography::Ingest(Input* input)
+{
+    tracelog("querying " << input->number);
+    Protocol block[protocol::kMaxRun];
+    std::size_t count = input->number->EgestMany(block, protocol::kMaxRun);
+    bool end;
+    protocol::Matrix m = protocol::InputMatrix(block, count, &end);
+    if (block[0] != Protocol::End)
+    {
+        while (!std::visit([&](auto& c) { return Substitute(&c, input, m); }, _state))
+        {
+            MakeRoom();
+        }
+    }
+    if (end)
+    {
+        std::visit([&](auto& c) { End(&c, input); }, _state);
+        if (_exhausted)
+        {
+            return false;
+        }
+    }
+    /*
+     * Amplify and Uncover narrow the input range,
+     * so a pole once out of range never comes back.
+     */
+    if (block[0] != Protocol::Amplify && block[0] != Protocol::Uncover)
+    {
+        _pole_in_range = true;
+    }
+    return true;
+}
+
+template <typename T>
+bool Bihomography::Substitute(Coefficients<T>* c, Input* input, const protocol::Matrix& m)
+{
+    Coefficients<T> r = *c;
+    bool x = input == &_x;
+    // Terms of first order in the input, paired with their counterparts.
+    T* first[] = { &r.n11, x ? &r.n10 : &r.n01, &r.d11, x ? &r.d10 : &r.d01 };
+    T* second[] = { x ? &r.n01 : &r.n10, &r.n00, x ? &r.d01 : &r.d10, &r.d00 };
+    if (!SubstituteTerms(m, first, second))
+    {
+        return false;
+    }
+    T* terms[] = { &r.n11, &r.n10, &r.n01, &r.n00, &r.d11, &r.d10, &r.d01, &r.d00 };
+    TakeOutTwos(terms);
+    *c = std::move(r);
+    tracelog("ingesting " << m.a << " " << m.b << " " << m.c << " " << m.d << " from " << input->number
+             << ", new state " << c->n11 << " " << c->n10 << " " << c->n01 << " " << c->n00
+             << " " << c->d11 << " " << c->d10 << " " << c->d01 << " " << c->d00);
+    return true;
+}
+
+template <typename T>
+void Bihomography::End(Coefficients<T>* c, Input* input)
+{
+    // The input ends at 0, dropping its terms.
+    tracelog("end of input " << input->number);
+    bool x = input == &_x;
+    T d1 = x ? c->d10 : c->d01;
+    for (T* a : { &c->n11, x ? &c->n10 : &c->n01, &c->d11, x ? &c->d10 : &c->d01 })
+    {
+        *a = 0;
+    }
+    input->ended = true;
+    delete input->number;
+    input->number = nullptr;
+    if (!_x.ended || !_y.ended)
+    {
+        if (_has_pole && !c->d10 && !c->d01 && !c->d00)
+        {
+            tracelog("denominator vanished");
+            Raise<UndefinedRatioError>();
+        }
+        T* n[] = { &c->n11, &c->n10, &c->n01, &c->n00 };
+        T* d[] = { &c->d11, &c->d10, &c->d01, &c->d00 };
+        _constant = Proportional(n, d);
+        _next = x ? &_y : &_x;
+        return;
+    }
+    if (!c->d00)
+    {
+        tracelog("pole at 0");
+        if (_has_pole)
+        {
+            tracelog("and pole is primal");
+            Raise<UndefinedRatioError>();
+        }
+        // The output is infinite; only the sign of n00 matters.
+        if (c->n00)
+        {
+            c->n00 = (c->n00 > 0) == (d1 >= 0) ? 1 : -1;
+        }
+    }
+    _exhausted = true;
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
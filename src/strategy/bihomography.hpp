@@ -0,0 +1,184 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_STRATEGY_BIHOMOGRAPHY_HPP_
+#define SRC_STRATEGY_BIHOMOGRAPHY_HPP_
+
+#include <cstdint>
+#include <variant>
+
+#include "arithmetic/integer.hpp"
+#include "protocol/matrix.hpp"
+#include "strategy.hpp"
+
+namespace deepnum
+{
+
+namespace clarith
+{
+
+class Number;
+
+namespace strategy
+{
+
+/**
+ * Bihomographic transformation.
+ * This strategy accepts Numbers \f$x\f$ and \f$y\f$ as input and outputs
+ * \f$z=\frac{n_{11}xy + n_{10}x + n_{01}y + n_{00}}{d_{11}xy + d_{10}x + d_{01}y + d_{00}}\f$
+ * where the coefficients are signed integers.
+ * Sum, Difference, Product and Quotient build the four arithmetic operations,
+ * allocating the strategy from the memory resource of \f$x\f$.
+ *
+ * Works like Homography: input is ingested in blocks of messages through
+ * their substitution matrices, and coefficients are reduced or promoted
+ * to wider types when they overflow.
+ * The output range is bounded by its values at the four corners of the
+ * input range; when it does not fit a message region, the input that
+ * spreads it is ingested.
+ * \see Homography, Strategy
+ */
+class Bihomography : public Strategy
+{
+ public:
+
+    /**
+     * Coefficients of the transformation.
+     * \tparam T Signed integer type.
+     */
+    template <typename T>
+    struct Coefficients
+    {
+        T n11, n10, n01, n00, d11, d10, d01, d00;
+    };
+
+    /**
+     * Coefficients in the narrowest type that holds them.
+     */
+    using State = std::variant<
+            Coefficients<int>,
+            Coefficients<std::int64_t>,
+            Coefficients<__int128>,
+            Coefficients<arithmetic::Integer>>;
+
+    Bihomography(const Bihomography&) = delete;
+    Bihomography& operator=(const Bihomography&) = delete;
+    Bihomography(Bihomography&&) = delete;
+    Bihomography& operator=(Bihomography&&) = delete;
+
+    ~Bihomography();
+
+    /**
+     * \param x First input.
+     * \param y Second input.
+     * \param n11 Numerator coefficient of xy.
+     * \param n10 Numerator coefficient of x.
+     * \param n01 Numerator coefficient of y.
+     * \param n00 Independent numerator coefficient.
+     * \param d11 Denominator coefficient of xy.
+     * \param d10 Denominator coefficient of x.
+     * \param d01 Denominator coefficient of y.
+     * \param d00 Independent denominator coefficient.
+     * \pre x and y not null, and dynamically allocated.
+     * \see strategy::Bihomography
+     * \throws UndefinedRatioError
+     */
+    Bihomography(gsl::owner<Number*> x, gsl::owner<Number*> y,
+                 int n11, int n10, int n01, int n00, int d11, int d10, int d01, int d00);
+
+    /**
+     * \return Strategy for \f$x+y\f$.
+     */
+    static gsl::owner<Bihomography*> Sum(gsl::owner<Number*> x, gsl::owner<Number*> y);
+
+    /**
+     * \return Strategy for \f$x-y\f$.
+     */
+    static gsl::owner<Bihomography*> Difference(gsl::owner<Number*> x, gsl::owner<Number*> y);
+
+    /**
+     * \return Strategy for \f$xy\f$.
+     */
+    static gsl::owner<Bihomography*> Product(gsl::owner<Number*> x, gsl::owner<Number*> y);
+
+    /**
+     * \return Strategy for \f$x/y\f$.
+     */
+    static gsl::owner<Bihomography*> Quotient(gsl::owner<Number*> x, gsl::owner<Number*> y);
+
+    bool Egest(protocol::Protocol* message) override;
+
+    /**
+     * Extracts Protocol messages until more input is needed.
+     * \see Strategy::EgestMany
+     */
+    std::size_t EgestMany(protocol::Protocol* out, std::size_t max) override;
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override;
+    bool SucceedInto(Number* number) const override;
+
+    /**
+     * Output value once the strategy is exhausted.
+     * The output is the ratio of coefficients n00 and d00.
+     * \return Final coefficients.
+     * \throw UnavailableError
+     * \see GetNewStrategy
+     */
+    const State& GetResult() const;
+
+ private:
+
+    enum class Step { Full, NeedInput, Point, Overflow };
+
+    // Input of a bihomography.
+    struct Input
+    {
+        Number* number;
+        bool ended;
+    };
+
+    template <typename T>
+    Step EgestMany(Coefficients<T>* c, protocol::Protocol* out, std::size_t max, std::size_t* count);
+    template <typename T>
+    bool Egest(Coefficients<T>* c, protocol::Protocol output);
+    template <typename T>
+    bool Substitute(Coefficients<T>* c, Input* input, const protocol::Matrix& m);
+    template <typename T>
+    void End(Coefficients<T>* c, Input* input);
+    bool Ingest(Input* input);
+    void MakeRoom();
+    void Promote();
+
+    Input _x;
+    Input _y;
+    // Input to ingest next.
+    Input* _next;
+    State _state;
+    bool _primed;
+    bool _exhausted;
+    bool _has_pole;
+    bool _pole_in_range;
+    bool _constant;
+};
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_STRATEGY_BIHOMOGRAPHY_HPP_
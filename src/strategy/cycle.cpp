@@ -0,0 +1,92 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+
+#include "cycle.hpp"
+
+#include "tracelog.h"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+void Cycle::Record(const protocol::Protocol* out, std::size_t count)
+{
+    if (HasGivenUp())
+    {
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        output_.Append(out[i]);
+    }
+}
+
+bool Cycle::Check(const __int128* state, std::size_t size)
+{
+    if (HasGivenUp())
+    {
+        return false;
+    }
+    ++steps_;
+    if (output_.Size() && checkpoint_.size() == size && std::equal(state, state + size, checkpoint_.begin()))
+    {
+        tracelog("state repeats after " << steps_ << " steps and " << output_.Size() << " messages");
+        return true;
+    }
+    if (steps_ >= window_)
+    {
+        // Move the checkpoint here.
+        checkpoint_.assign(state, state + size);
+        output_ = protocol::Buffer();
+        steps_ = 0;
+        window_ *= 2;
+        if (HasGivenUp())
+        {
+            tracelog("giving up");
+        }
+    }
+    return false;
+}
+
+void Cycle::GiveUp()
+{
+    tracelog("giving up");
+    window_ = 2 * kMaxWindow;
+    output_ = protocol::Buffer();
+}
+
+bool Cycle::HasGivenUp() const
+{
+    return window_ > kMaxWindow;
+}
+
+protocol::Buffer& Cycle::Period()
+{
+    return output_;
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_STRATEGY_CYCLE_HPP_
+#define SRC_STRATEGY_CYCLE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "allocatable.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+/**
+ * Detector of cycles in the state of a strategy.
+ * A strategy whose inputs are eventually periodic, and whose next state
+ * only depends on its current state and on the position of its inputs in
+ * their periods, is eventually periodic as well: once it is back at a
+ * state it has been at, it outputs again what it has output since then,
+ * forever.
+ *
+ * The strategy records its output and submits its state after every
+ * step. States are compared against a checkpoint, that moves ahead to the
+ * current state whenever the number of steps since the checkpoint reaches
+ * a window that doubles each time (Brent's algorithm); so a cycle is
+ * found within a few times its length, keeping a single state.
+ * Detection gives up when the window gets too large.
+ *
+ * Strategies allocate their detector from the memory resource of their
+ * input.
+ */
+class Cycle : public Allocatable
+{
+ public:
+
+    Cycle(const Cycle&) = delete;
+    Cycle& operator=(const Cycle&) = delete;
+    Cycle(Cycle&&) = delete;
+    Cycle& operator=(Cycle&&) = delete;
+
+    Cycle() = default;
+
+    /**
+     * Records output of the strategy, unless detection has given up.
+     * \param[in] out Output messages.
+     * \param[in] count Number of messages.
+     */
+    void Record(const protocol::Protocol* out, std::size_t count);
+
+    /**
+     * Compares the current state with the checkpoint.
+     * \param[in] state State of the strategy in normal form, such as the
+     *            one given by NormalizeTerms, and positions of its inputs.
+     * \param[in] size Number of elements of state.
+     * \return Was the state seen before, with some output since then?
+     * \see Period
+     */
+    bool Check(const __int128* state, std::size_t size);
+
+    /**
+     * Stops detection, for states that have no normal form.
+     */
+    void GiveUp();
+
+    /**
+     * \return Has detection given up?
+     */
+    bool HasGivenUp() const;
+
+    /**
+     * Output of the strategy over one period of its cycle.
+     * \pre Check has answered true.
+     */
+    protocol::Buffer& Period();
+
+ private:
+
+    static constexpr std::size_t kMaxWindow = std::size_t(1) << 16;
+
+    std::vector<__int128> checkpoint_;
+    protocol::Buffer output_;
+    std::size_t steps_ { 0 };
+    std::size_t window_ { 1 };
+};
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_STRATEGY_CYCLE_HPP_
@@ -17,24 +17,40 @@
  * You should have received a copy of the GNU General Public License
  * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
  */
-
-#include <cassert>
-#include <cmath>
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
+#include "arithmetic/bits.hpp"
+#include "arithmetic/checked.hpp"
 #include "number.hpp"
+#include "protocol/matrix.hpp"
 #include "protocol/protocol.hpp"
-#include "strategy/zero.hpp"
-#include "strategy/exhaustion_error.hpp"
+#include "raise.hpp"
+#include "statistics.hpp"
+#include "strategy/cycle.hpp"
+#include "strategy/playback.hpp"
 #include "strategy/ratio.hpp"
+#include "strategy/rewrite.hpp"
+#include "strategy/terms.hpp"
+#include "strategy/transposition_table.hpp"
 #include "strategy/unavailable_error.hpp"
 #include "strategy/undefined_ratio_error.hpp"
-#include "util.hpp"
+#include "strategy/zero.hpp"
 
 #include "homography.hpp"
 
 #include "tracelog.h"
 
+using deepnum::clarith::arithmetic::Add;
+using deepnum::clarith::arithmetic::Divide;
+using deepnum::clarith::arithmetic::Fits;
+using deepnum::clarith::arithmetic::Gcd;
+using deepnum::clarith::arithmetic::Integer;
+using deepnum::clarith::arithmetic::Magnitude;
+using deepnum::clarith::arithmetic::Wider;
 using deepnum::clarith::protocol::Protocol;
 
 namespace deepnum
@@ -46,412 +62,706 @@ namespace clarith
 namespace strategy
 {
 
-Homography::Homography(Number* x, int n1, int n0, int d1, int d0)
-        : _x(x), _n1(n1), _n0(n0), _d1(d1), _d0(d0),
+namespace
+{
+
+// Value p/q of a ratio strategy s.
+template <typename R>
+bool GetValue(Strategy* s, __int128* p, __int128* q)
+{
+    auto* r = dynamic_cast<R*>(s);
+    if (!r)
+    {
+        return false;
+    }
+    *p = r->IsPositive() ? __int128(r->Numerator()) : -__int128(r->Numerator());
+    *q = r->Denominator();
+    return true;
+}
+
+}  // namespace
+
+struct Homography::Transition : Allocatable
+{
+    explicit Transition(TranspositionTable* table)
+            : table(table)
+    {
+    }
+
+    TranspositionTable* table;
+    TranspositionTable::Key key {};
+    bool recording { false };
+    // Messages recorded, or to replay from position at on.
+    std::size_t size { 0 };
+    std::size_t at { 0 };
+    Protocol messages[TranspositionTable::kMaxOutput] {};
+};
+
+Homography::Homography(Number* x, int n1, int n0, int d1, int d0, Reduction reduction)
+        : _x(x), _state(Coefficients<int> { n1, n0, d1, d0 }),
+        _reduction(reduction),
         _primed(false),
         _exhausted(false),
-        _has_pole(d1)
+        _has_pole(d1),
+        _pole_in_range(true),
+        // Every transform keeps the determinant zero or not zero.
+        _constant(std::int64_t(n1) * d0 == std::int64_t(n0) * d1),
+        _cycle(nullptr),
+        _periodic(false),
+        _transition(nullptr)
 {
-    tracelog(x << " " << _n1 << " " << _n0 << " " << _d1 << " " << _d0);
+    tracelog(x << " " << n1 << " " << n0 << " " << d1 << " " << d0);
     if (!n1 && !n0 && !d1 && !d0)
     {
         delete _x;
-        throw UndefinedRatioError();
+        Raise<UndefinedRatioError>();
     }
-    if (!_n1 && !_d1)
+    if (!n1 && !d1)
     {
         // input is dropped
         _exhausted = true;
         return;
     }
+    Compose();
+    Evaluate();
+    if (TranspositionTable* table = TranspositionTable::Current(); table && !_exhausted)
+    {
+        _transition = new (GetResource(_x)) Transition(table);
+    }
+}
+
+Number* Homography::Make(Number* x, int n1, int n0, int d1, int d0)
+{
+    std::pmr::memory_resource* resource = GetResource(x);
+    if (!d1 && !n0 && n1 && d0)
+    {
+        // x scaled by n1/d0.
+        auto p = Magnitude(n1);
+        auto q = Magnitude(d0);
+        if (!(p & (p - 1)) && !(q & (q - 1)))
+        {
+            int exponent = int(arithmetic::CountTrailingZeros(p)) - int(arithmetic::CountTrailingZeros(q));
+            if (exponent)
+            {
+                x = new (resource) Number(new (resource) Scaling(x, exponent));
+            }
+            return (n1 > 0) == (d0 > 0) ? x : new (resource) Number(new (resource) Negation(x));
+        }
+    }
+    if (!n1 && !d0 && n0 && d1 && Magnitude(n0) == Magnitude(d1))
+    {
+        x = new (resource) Number(new (resource) Reciprocation(x));
+        return (n0 > 0) == (d1 > 0) ? x : new (resource) Number(new (resource) Negation(x));
+    }
+    return new (resource) Number(std::in_place_type<Homography>, x, n1, n0, d1, d0);
+}
+
+Homography::Homography(Homography&& other) noexcept
+        : Strategy(std::move(other)),
+        _x(std::exchange(other._x, nullptr)),
+        _state(std::move(other._state)),
+        _reduction(other._reduction),
+        _primed(other._primed),
+        _exhausted(other._exhausted),
+        _has_pole(other._has_pole),
+        _pole_in_range(other._pole_in_range),
+        _constant(other._constant),
+        _cycle(std::exchange(other._cycle, nullptr)),
+        _periodic(other._periodic),
+        _transition(std::exchange(other._transition, nullptr))
+{
+    tracelog(&other);
 }
 
 Homography::~Homography()
 {
     tracelog("");
     delete _x;
+    delete _cycle;
+    delete _transition;
 }
 
-protocol::Protocol Homography::Egest()
+void Homography::Compose()
 {
-    if (_exhausted)
+    /*
+     * y = (ax+b)/(cx+d)
+     * (n1y+n0)/(d1y+d0) = ((n1a+n0c)x+(n1b+n0d))/((d1a+d0c)x+(d1b+d0d))
+     *
+     * The composition loses the pole of y unless y is affine (c = 0);
+     * it keeps it when the outer transformation is affine (d1 = 0),
+     * as the denominator is then a multiple of that of y.
+     */
+    auto* inner = dynamic_cast<Homography*>(_x->GetStrategy());
+    if (!inner || inner->_primed || inner->_exhausted)
     {
-        throw ExhaustionError();
+        return;
     }
-    if (!_primed)
+    const auto& o = std::get<Coefficients<int>>(_state);
+    const auto* i = std::get_if<Coefficients<int>>(&inner->_state);
+    if (!i || (o.d1 && i->d1))
     {
-        _primed = true;
-        // Input is completely unknown; make it lie between 0 and 1.
-        Ingest();
+        return;
     }
-
-    Protocol output;
-    do
+    using Wide = __int128;
+    Coefficients<Wide> c {
+        Wide(o.n1) * i->n1 + Wide(o.n0) * i->d1,
+        Wide(o.n1) * i->n0 + Wide(o.n0) * i->d0,
+        Wide(o.d1) * i->n1 + Wide(o.d0) * i->d1,
+        Wide(o.d1) * i->n0 + Wide(o.d0) * i->d0,
+    };
+    if (!c.n1 && !c.d1)
     {
-
-        int min_n, min_d, max_n, max_d;
-        DetectOutputRange(&min_n, &min_d, &max_n, &max_d);
-        tracelog("output range min " << min_n << " " << min_d << " max " << max_n << " " << max_d);
-        if (min_n == max_n && min_d == max_d)
+        return;
+    }
+    auto divisor = Gcd(Gcd(Magnitude(c.n1), Magnitude(c.n0)), Gcd(Magnitude(c.d1), Magnitude(c.d0)));
+    for (Wide* a : { &c.n1, &c.n0, &c.d1, &c.d0 })
+    {
+        *a = Divide(*a, divisor);
+        if (!Fits<int>(*a))
         {
-            tracelog("output range is a point");
-            _exhausted = true;
-            throw ExhaustionError();
+            return;
         }
-        output = CanEgest(min_n, min_d, max_n, max_d);
-        if (output == Protocol::End)
+    }
+    tracelog("folding " << _x << " into " << this);
+    statcount(compositions);
+    _state = Coefficients<int> { int(c.n1), int(c.n0), int(c.d1), int(c.d0) };
+    _has_pole = c.d1;
+    _constant = c.n1 * c.d0 == c.n0 * c.d1;
+    Number* x = _x;
+    _x = std::exchange(inner->_x, nullptr);
+    delete x;
+}
+
+void Homography::Evaluate()
+{
+    // Input value p/q.
+    __int128 p;
+    __int128 q;
+    Strategy* s = _x->GetStrategy();
+    auto* inner = dynamic_cast<Homography*>(s);
+    if (dynamic_cast<Zero*>(s))
+    {
+        p = 0;
+        q = 1;
+    }
+    else if (!GetValue<Ratio>(s, &p, &q) && !GetValue<Ratio64>(s, &p, &q))
+    {
+        // Wider results could overflow the products below.
+        if (!inner || !inner->_exhausted || !std::visit([&p, &q](const auto& c) {
+                    using T = std::decay_t<decltype(c.n0)>;
+                    if constexpr (std::is_same_v<T, int> || std::is_same_v<T, std::int64_t>)
+                    {
+                        p = c.n0;
+                        q = c.d0;
+                        return true;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }, inner->_state))
         {
-            tracelog("need more input");
-            Ingest();
+            return;
         }
+    }
+    if (!q)
+    {
+        return;
+    }
+    const auto& c = std::get<Coefficients<int>>(_state);
+    __int128 n = c.n1 * p + c.n0 * q;
+    __int128 d = c.d1 * p + c.d0 * q;
+    if (!d)
+    {
+        return;
+    }
+    auto divisor = Gcd(Magnitude(n), Magnitude(d));
+    n = Divide(n, divisor);
+    d = Divide(d, divisor);
+    tracelog("evaluating at " << p << "/" << q << ": " << n << "/" << d);
+    statcount(evaluations);
+    if (Fits<int>(n) && Fits<int>(d))
+    {
+        _state = Coefficients<int> { 0, int(n), 0, int(d) };
+    }
+    else if (Fits<std::int64_t>(n) && Fits<std::int64_t>(d))
+    {
+        _state = Coefficients<std::int64_t> { 0, std::int64_t(n), 0, std::int64_t(d) };
+    }
+    else
+    {
+        _state = Coefficients<__int128> { 0, n, 0, d };
+    }
+    _exhausted = true;
+    delete _x;
+    _x = nullptr;
+}
 
-    } while (output == Protocol::End);
-    return Egest(output);
-
+bool Homography::Egest(Protocol* message)
+{
+    return Homography::EgestMany(message, 1);
 }
 
-void Homography::DetectOutputRange(int* min_n, int* min_d, int* max_n, int* max_d)
+std::size_t Homography::EgestMany(Protocol* out, std::size_t max)
 {
+    std::size_t count = Run(out, max);
+    if (_cycle)
+    {
+        // Input is only ingested before any output of a call.
+        _cycle->Record(out, count);
+    }
+    return count;
+}
 
-    if (_n0 || _d0)
+std::size_t Homography::Run(Protocol* out, std::size_t max)
+{
+    if (_exhausted)
     {
-        *min_n = *max_n = _n0;
-        *min_d = *max_d = _d0;
-        tracelog("output at 0 is " << _n0 << " " << _d0);
+        return 0;
     }
-    else
+    if (!_primed)
+    {
+        _primed = true;
+        // Input is completely unknown; make it lie between 0 and 1.
+        if (!Ingest())
+        {
+            return 0;
+        }
+    }
+    if (_transition && _transition->at < _transition->size)
     {
-        tracelog("output at 0 is undefined");
-        *min_n = -1;
-        *max_n = 1;
-        *min_d = *max_d = 0;
+        return Replay(out, max);
     }
 
-    int n, d;
-    assert(!__builtin_add_overflow(_n1, _n0, &n));
-    assert(!__builtin_add_overflow(_d1, _d0, &d));
-    // int n = _n1 + _n0;
-    // int d = _d1 + _d0;
-    if (n || d)
+    std::size_t count = 0;
+    while (count < max)
     {
-        tracelog("output at 1 is " << n << " " << d);
-        MinMax(min_n, min_d, max_n, max_d, n, d);
+
+        std::size_t start = count;
+        Step step = std::visit([&](auto& c) { return EgestMany(&c, out, max, &count); }, _state);
+        if (_transition && _transition->recording)
+        {
+            Remember(out + start, count - start);
+        }
+        switch (step)
+        {
+            case Step::Full:
+                break;
+            case Step::Point:
+                tracelog("output range is a point");
+                _exhausted = true;
+                return count;
+            case Step::NeedInput:
+                if (_transition)
+                {
+                    Settle();
+                }
+                if (count)
+                {
+                    // Deliver what is known before asking input for more.
+                    return count;
+                }
+                tracelog("need more input");
+                if (!Ingest())
+                {
+                    return count;
+                }
+                if (_transition && _transition->at < _transition->size)
+                {
+                    return Replay(out, max);
+                }
+                break;
+            case Step::Overflow:
+                MakeRoom();
+                break;
+        }
+
     }
-    else
+    return count;
+
+}
+
+template <typename T>
+Homography::Step Homography::EgestMany(Coefficients<T>* c, Protocol* out, std::size_t max, std::size_t* count)
+{
+    while (*count < max)
     {
-        tracelog("output at 1 is undefined");
-        *min_n = -1;
-        *max_n = 1;
-        *min_d = *max_d = 0;
+        if (_pole_in_range)
+        {
+            tracelog("has a pole between 0 and 1");
+            return Step::NeedInput;
+        }
+        if (_constant && (c->n0 || c->d0))
+        {
+            return Step::Point;
+        }
+        /*
+         * Without a pole, the output range lies between the outputs at 0
+         * and at 1. A message can be egested if both lie in its region.
+         */
+        T n, d;
+        if (!Add(c->n1, c->n0, &n) || !Add(c->d1, c->d0, &d))
+        {
+            return Step::Overflow;
+        }
+        statcount(range_tests);
+        Protocol output = Classify(c->n0, c->d0);
+        tracelog("output at 0 is " << c->n0 << " " << c->d0 << ", output at 1 is " << n << " " << d);
+        if (output == Protocol::End || output != Classify(n, d))
+        {
+            return Step::NeedInput;
+        }
+        if (!Egest(c, output))
+        {
+            return Step::Overflow;
+        }
+        out[(*count)++] = output;
     }
+    return Step::Full;
+}
 
-    if (IsBetweenZeroAndOne(-_n0, _n1)) {
-        tracelog("has a zero between 0 and 1");
-        MinMax(min_n, min_d, max_n, max_d, 0, 1);
+void Homography::MakeRoom()
+{
+    if (_reduction == Reduction::Never || !Reduce())
+    {
+        Promote();
     }
+}
 
-    if (IsBetweenZeroAndOne(-_d0, _d1))
+bool Homography::Reduce()
+{
+    bool reduced = std::visit([](auto& c) {
+        decltype(&c.n1) terms[] = { &c.n1, &c.n0, &c.d1, &c.d0 };
+        return ReduceTerms(terms);
+    }, _state);
+    if (reduced)
     {
-        tracelog("has a pole between 0 and 1");
-        *min_n = -1;
-        *min_d = 0;
-        *max_n = 1;
-        *max_d = 0;
+        statcount(reductions);
+        tracelog("coefficients reduced");
     }
+    return reduced;
+}
 
+void Homography::Promote()
+{
+    statcount(promotions);
+    _state = std::visit([](auto& c) -> State {
+        using T = std::decay_t<decltype(c.n1)>;
+        if constexpr (std::is_same_v<T, Integer>)
+        {
+            Raise<std::logic_error>("arbitrary precision coefficients cannot overflow");
+            return c;
+        }
+        else
+        {
+            using W = typename Wider<T>::type;
+            return Coefficients<W> { W(c.n1), W(c.n0), W(c.d1), W(c.d0) };
+        }
+    }, _state);
+    tracelog("coefficients promoted to alternative " << _state.index());
 }
 
-void Homography::MinMax(int* min_n, int* min_d, int* max_n, int* max_d, int n, int d)
+template <typename T>
+bool Homography::HasRootBetweenZeroAndOne(const T& a1, const T& a0)
 {
-    if (Compare(n, d, *min_n, *min_d) < 0)
+    /*
+     * a1x+a0 = 0 => x = -a0/a1, which lies in [0, 1]
+     * iff a0 and a1 have opposite signs and |a0| <= |a1|.
+     * Neither test can overflow.
+     */
+    if (a1 > 0)
     {
-        *min_n = n;
-        *min_d = d;
+        return a0 <= 0 && a0 + a1 >= 0;
     }
-    if (Compare(n, d, *max_n, *max_d) > 0)
+    if (a1 < 0)
     {
-        *max_n = n;
-        *max_d = d;
+        return a0 >= 0 && a0 + a1 <= 0;
     }
+    return false;
 }
 
-bool Homography::IsBetweenZeroAndOne(int n, int d)
+template <typename T>
+bool Homography::Egest(Coefficients<T>* c, Protocol output)
 {
-    if (!n && !d) {
+    // Work on a copy, so that an overflow leaves coefficients untouched.
+    Coefficients<T> r = *c;
+    T* n[] = { &r.n1, &r.n0 };
+    T* d[] = { &r.d1, &r.d0 };
+    if (!EgestTerms(output, n, d))
+    {
         return false;
     }
-    if (d < 0) {
-        n *= -1;
-        d *= -1;
-    }
-    return n >= 0 && n <= d;
+    *c = std::move(r);
+    tracelog("egesting " << output << ", new state " << c->n1 << " " << c->n0 << " " << c->d1 << " " << c->d0);
+    return true;
 }
 
-Protocol Homography::CanEgest(int min_n, int min_d, int max_n, int max_d)
+Strategy* Homography::GetNewStrategy(std::pmr::memory_resource* resource) const
 {
-    assert(min_n || max_n);
-    if (Compare(max_n, max_d, -1, 1) < 0) { return Protocol::Ground; }
-    if (Compare(min_n, min_d, 1, 1) > 0) { return Protocol::Turn; }
-    if (Compare(max_n, max_d, 0, 1) < 0 && Compare(min_n, min_d, -1, 1) >= 0) { return Protocol::Reflect; }
-    if (Compare(min_n, min_d, 1, 2) > 0 && Compare(max_n, max_d, 1, 1) <= 0) { return Protocol::Uncover; }
-    if (Compare(min_n, min_d, 0, 1) > 0 && Compare(max_n, max_d, 1, 2) <= 0) { return Protocol::Amplify; }
-    return Protocol::End;
+    if (_periodic)
+    {
+        return new (resource) Playback(*GetPeriod(), 0);
+    }
+    return std::visit([resource](const auto& c) -> Strategy* {
+        using Result = typename RatioOf<std::decay_t<decltype(c.n0)>>::type;
+        return new (resource) Result(c.n0, c.d0);
+    }, GetResult());
 }
 
-Protocol Homography::Egest(Protocol output)
+bool Homography::SucceedInto(Number* number) const
 {
-    switch (output)
+    if (_periodic)
     {
-        case Protocol::Amplify:
-            /*
-             * 2(n1x+n0)/(d1x+d0)
-             * = ((2n1)x+(2n0))/(d1x+d0)
-             * = (n1x+n0)/((d1/2)x+(d0/2))
-             */
-            if (_d1 % 2 || _d0 % 2)
-            {
-                assert(!__builtin_mul_overflow(_n1, 2, &_n1));
-                assert(!__builtin_mul_overflow(_n0, 2, &_n0));
-            }
-            else
-            {
-                _d1 /= 2;
-                _d0 /= 2;
-            }
-            break;
-        case Protocol:: Uncover:
-            /*
-             * 1/((n1x+n0)/(d1x+d0))-1
-             * = (d1x+d0)/(n1x+n0)-1
-             * = (d1x+d0)/(n1x+n0)-(n1x+n0)/(n1x+n0)
-             * = ((d1-n1)x+(d0-n0))/(n1x+n0)
-             */
-            assert(!__builtin_sub_overflow(_d1, _n1, &_d1));
-            assert(!__builtin_sub_overflow(_d0, _n0, &_d0));
-            std::swap(_n1, _d1);
-            std::swap(_n0, _d0);
-            break;
-        case Protocol:: Turn:
-            /*
-             * 1/((n1x+n0)/(d1x+d0))
-             * = (d1x+d0)/(n1x+n0)
-             */
-            std::swap(_n1, _d1);
-            std::swap(_n0, _d0);
-            break;
-        case Protocol:: Reflect:
-            /*
-             * -((n1x+n0)/(d1x+d0))
-             * = ((-n1)x+(-n0))/(d1x+d0)
-             */
-            assert(!__builtin_mul_overflow(_n1, -1, &_n1));
-            assert(!__builtin_mul_overflow(_n0, -1, &_n0));
-            break;
-        case Protocol:: Ground:
-            /*
-             * 1/(-(n1x+n0)/(d1x+d0))
-             * = -(d1x+d0)/(n1x+n0)
-             * = ((-d1)x+(-d0))/(n1x+n0)
-             */
-            assert(!__builtin_mul_overflow(_d1, -1, &_d1));
-            assert(!__builtin_mul_overflow(_d0, -1, &_d0));
-            std::swap(_n1, _d1);
-            std::swap(_n0, _d0);
-            break;
-        default:
-            throw std::logic_error("unhandled protocol message");
-    }
-    tracelog("egesting " << output << ", new state " << _n1 << " " << _n0 << " " << _d1 << " " << _d0);
-    return output;
+        Succeed<Playback>(number, *GetPeriod(), 0);
+        return true;
+    }
+    std::visit([number](const auto& c) {
+        using Result = typename RatioOf<std::decay_t<decltype(c.n0)>>::type;
+        Succeed<Result>(number, c.n0, c.d0);
+    }, GetResult());
+    return true;
 }
 
-Strategy* Homography::GetNewStrategy() const
+const Homography::State& Homography::GetResult() const
 {
-    if (!_exhausted)
+    if (!_exhausted || _periodic)
     {
-        throw UnavailableError();
+        Raise<UnavailableError>();
     }
-    return new Ratio(_n0, _d0);
+    return _state;
 }
 
-int Homography::Compare(int n1, int d1, int n2, int d2)
+const protocol::Buffer* Homography::GetPeriod() const
 {
-    assert(n1 || d1);
-    assert(n2 || d2);
-    int n1_ = n1;
-    int d1_ = d1;
-    int n2_ = n2;
-    int d2_ = d2;
-    if (!d1_)
+    if (!_exhausted)
     {
-        n1_ = n1_ > 0 ? 1 : -1;
+        Raise<UnavailableError>();
     }
-    else if (d1_ < 0)
+    return _periodic ? &_cycle->Period() : nullptr;
+}
+
+bool Homography::Ingest()
+{
+    /*
+     * Input is taken in blocks: the substitutions of all messages of a block
+     * are multiplied together (tail messages come from a table) and applied
+     * to the coefficients at once.
+     */
+    bool transposed;
+    do
     {
-        if (__builtin_mul_overflow(n1_, -1, &n1_))
+        tracelog("querying " << _x);
+        Protocol block[protocol::kMaxRun];
+        std::size_t count = _x->EgestMany(block, protocol::kMaxRun);
+        transposed = Transpose(block, count);
+        if (!transposed && !Apply(block, count))
         {
-            goto compare_fallback;
+            return false;
         }
-        if (__builtin_mul_overflow(d1_, -1, &d1_))
+        if (Repeats())
+        {
+            tracelog("output is periodic");
+            _periodic = true;
+            _exhausted = true;
+            return false;
+        }
+        // Transitions without output end up needing input again.
+    } while (transposed && !_transition->size);
+    return true;
+}
+
+bool Homography::Apply(const Protocol* block, std::size_t count)
+{
+    bool end;
+    protocol::Matrix m = protocol::InputMatrix(block, count, &end);
+    if (block[0] != Protocol::End)
+    {
+        while (!std::visit([&](auto& c) { return Substitute(&c, m); }, _state))
         {
-            goto compare_fallback;
+            MakeRoom();
         }
     }
-    if (!d2_)
+    if (end)
     {
-        n2_ = n2_ > 0 ? 1 : -1;
+        tracelog("end of input");
+        std::visit([this](auto& c) {
+            if (!c.d0)
+            {
+                tracelog("pole at 0");
+                if (_has_pole)
+                {
+                    tracelog("and pole is primal");
+                    Raise<UndefinedRatioError>();
+                }
+                // The output is infinite; only the sign of n0 matters.
+                if (c.n0)
+                {
+                    c.n0 = (c.n0 > 0) == (c.d1 >= 0) ? 1 : -1;
+                }
+            }
+        }, _state);
+        _exhausted = true;
+        return false;
     }
-    else if (d2_ < 0)
+    if (_reduction == Reduction::Always)
     {
-        if (__builtin_mul_overflow(n2_, -1, &n2_))
-        {
-            goto compare_fallback;
-        }
-        if (__builtin_mul_overflow(d2_, -1, &d2_))
-        {
-            goto compare_fallback;
-        }
+        Reduce();
     }
-    int c;
-    if (d1_ || d2_)
+    /*
+     * Amplify and Uncover narrow the input range,
+     * so a pole once out of range never comes back.
+     */
+    if (_pole_in_range || (block[0] != Protocol::Amplify && block[0] != Protocol::Uncover))
     {
-        int t1, t2;
-        if (__builtin_mul_overflow(n1_, d2_, &t1))
-        {
-            goto compare_fallback;
-        }
-        if (__builtin_mul_overflow(n2_, d1_, &t2))
+        _pole_in_range = std::visit([](const auto& c) { return HasRootBetweenZeroAndOne(c.d1, c.d0); }, _state);
+    }
+    return true;
+}
+
+bool Homography::Transpose(const Protocol* block, std::size_t count)
+{
+    /*
+     * Only full runs of Amplify and Uncover from machine integer states
+     * are cached; these are the bulk of the input.
+     */
+    if (!_transition)
+    {
+        return false;
+    }
+    Transition& t = *_transition;
+    t.recording = false;
+    t.size = t.at = 0;
+    auto* c = std::get_if<Coefficients<int>>(&_state);
+    if (!c || count < protocol::kMaxRun)
+    {
+        return false;
+    }
+    std::uint32_t bits = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (block[i] == Protocol::Uncover)
         {
-            goto compare_fallback;
+            bits |= 1u << i;
         }
-        if (__builtin_sub_overflow(t1, t2, &c))
+        else if (block[i] != Protocol::Amplify)
         {
-            goto compare_fallback;
+            return false;
         }
     }
-    else
+    // Transitions also depend on the pole and on how overflows are handled.
+    t.key = TranspositionTable::Key {
+        { c->n1, c->n0, c->d1, c->d0 },
+        bits | std::uint32_t(_pole_in_range) << 8 | std::uint32_t(_constant) << 9
+                | std::uint32_t(_reduction) << 10,
+    };
+    const TranspositionTable::Entry* entry = t.table->Find(t.key);
+    if (!entry)
     {
-        if (__builtin_sub_overflow(n1_, n2_, &c))
-        {
-            goto compare_fallback;
-        }
+        t.recording = true;
+        return false;
     }
-    return (c > 0) - (c < 0);
-compare_fallback:
-    traceloc("integer overflow; fallbacking to Ratio comparison");
-    return Util::Compare(new Number(new Ratio(n1, d1)), new Number(new Ratio(n2, d2)));
+    *c = Coefficients<int> { entry->state[0], entry->state[1], entry->state[2], entry->state[3] };
+    _pole_in_range = entry->pole_in_range;
+    std::transform(entry->output, entry->output + entry->size, t.messages,
+                   [](std::uint8_t message) { return Protocol(message); });
+    t.size = entry->size;
+    tracelog("transposed to state " << c->n1 << " " << c->n0 << " " << c->d1 << " " << c->d0
+             << " egesting " << t.size << " messages");
+    return true;
 }
 
-void Homography::Ingest()
+void Homography::Remember(const Protocol* out, std::size_t count)
 {
-    tracelog("querying " << _x);
-    Protocol input = _x->Egest();
-    switch (input)
+    Transition& t = *_transition;
+    if (t.size + count > TranspositionTable::kMaxOutput)
     {
-        case Protocol::End:
-            tracelog("end of input");
-            if (!_d0)
-            {
-                tracelog("pole at 0");
-                if (_has_pole)
-                {
-                    tracelog("and pole is primal");
-                    throw UndefinedRatioError();
-                }
-                if (_d1 < 0)
-                {
-                    assert(!__builtin_mul_overflow(_n0, -1, &_n0));
-                }
-            }
-            _exhausted = true;
-            throw ExhaustionError();
-        case Protocol::Amplify:
-            /*
-             * x2 = 2x1 => x1 = x2/2
-             *
-             * (n1x1+n0)/(d1x1+d0)
-             * = (n1(x2/2)+n0)/(d1(x2/2)+d0)
-             * = ((n1/2)x2+n0)/((d1/2)x2+d0)
-             * = (n1x2+2n0)/(d1x2+2d0)
-             */
-            if (_n1 % 2 || _d1 % 2)
-            {
-                assert(!__builtin_mul_overflow(_n0, 2, &_n0));
-                assert(!__builtin_mul_overflow(_d0, 2, &_d0));
-            }
-            else
-            {
-                _n1 /= 2;
-                _d1 /= 2;
-            }
-            break;
-        case Protocol::Uncover:
-            /*
-             * x2 = 1/x1-1 => 1/x1 = x2+1 => x1 = 1/(x2+1)
-             *
-             * (n1x1+n0)/(d1x1+d0)
-             * = (n1(1/(x2+1))+n0)/(d1(1/(x2+1)+d0)
-             * = (n1+n0(x2+1))/(d1+d0(x2+1))
-             * = (n1+n0x2+n0)/(d1+d0x2+d0)
-             * = (n0x2+(n1+n0))/(d0x2+(d1+d0))
-             */
-            assert(!__builtin_add_overflow(_n1, _n0, &_n1));
-            assert(!__builtin_add_overflow(_d1, _d0, &_d1));
-            std::swap(_n1, _n0);
-            std::swap(_d1, _d0);
-            break;
-        case Protocol::Turn:
-            /*
-             * x2 = 1/x1 => x1 = 1/x2
-             *
-             * (n1x1+n0)/(d1x1+d0)
-             * = (n1(1/x2)+n0)/(d1(1/x2)+d0)
-             * = (n1+n0x2)/(d1+d0x2)
-             * = (n0x2+n1)/(d0x2+d1)
-             */
-            std::swap(_n1, _n0);
-            std::swap(_d1, _d0);
-            break;
-        case Protocol::Reflect:
-            /*
-             * x2 = -x1 => x1 = -x2
-             *
-             * (n1x1+n0)/(d1x1+d0)
-             * = (n1(-x2)+n0)/(d1(-x2)+d0)
-             * = ((-n1)x2+n0)/((-d1)x2+d0)
-             * = (n1x2+(-n0))/(d1x2+(-d0))
-             */
-            if (_n0 || _d0)
-            {
-                assert(!__builtin_mul_overflow(_n0, -1, &_n0));
-                assert(!__builtin_mul_overflow(_d0, -1, &_d0));
-            }
-            else
-            {
-                assert(!__builtin_mul_overflow(_n1, -1, &_n1));
-                assert(!__builtin_mul_overflow(_d1, -1, &_d1));
-            }
-            break;
-        case Protocol::Ground:
-            /*
-             * x2 = -1/x1 => x1 = -1/x2
-             * = (n1(-1/x2)+n0)/(d1(-1/x2)+d0)
-             * = (-n1+n0x2)/(-d1+d0x2)
-             * = (n0x2+(-n1))/(d0x2+(-d1))
-             */
-            // FIXME: performance?
-            assert(!__builtin_mul_overflow(_n1, -1, &_n1));
-            assert(!__builtin_mul_overflow(_d1, -1, &_d1));
-            std::swap(_n1, _n0);
-            std::swap(_d1, _d0);
-            break;
-        default:
-            throw std::logic_error("unhandled protocol message");
-    }
-    tracelog("ingesting " << input << " from " << _x << ", new state " << _n1 << " " << _n0 << " " << _d1 << " " << _d0);
+        t.recording = false;
+        return;
+    }
+    std::copy(out, out + count, t.messages + t.size);
+    t.size += count;
+    t.at = t.size;
+}
+
+void Homography::Settle()
+{
+    Transition& t = *_transition;
+    if (!t.recording)
+    {
+        return;
+    }
+    t.recording = false;
+    if (const auto* c = std::get_if<Coefficients<int>>(&_state))
+    {
+        t.table->Store(t.key, { c->n1, c->n0, c->d1, c->d0 }, _pole_in_range, t.messages, t.size);
+    }
+}
+
+std::size_t Homography::Replay(Protocol* out, std::size_t max)
+{
+    Transition& t = *_transition;
+    std::size_t count = std::min(max, t.size - t.at);
+    std::copy(t.messages + t.at, t.messages + t.at + count, out);
+    t.at += count;
+    return count;
+}
+
+bool Homography::Repeats()
+{
+    /*
+     * The next state only depends on the current one and on the messages
+     * to come from the input; for a periodic input, these are told by its
+     * position. Coefficients are taken in normal form, as proportional
+     * coefficients egest and ingest alike.
+     */
+    if (_cycle && _cycle->HasGivenUp())
+    {
+        return false;
+    }
+    auto* playback = std::get_if<Playback>(&_x->strategy_);
+    if (!playback || !playback->IsPeriodic())
+    {
+        return false;
+    }
+    if (!_cycle)
+    {
+        tracelog("input is periodic");
+        _cycle = new (GetResource(_x)) Cycle();
+    }
+    __int128 normal[4];
+    if (!std::visit([&normal](const auto& c) {
+            decltype(&c.n1) terms[] = { &c.n1, &c.n0, &c.d1, &c.d0 };
+            return NormalizeTerms(terms, normal);
+        }, _state))
+    {
+        _cycle->GiveUp();
+        return false;
+    }
+    const __int128 state[] = {
+        normal[0], normal[1], normal[2], normal[3], _pole_in_range, __int128(playback->Position()),
+    };
+    return _cycle->Check(state, std::size(state));
+}
+
+template <typename T>
+bool Homography::Substitute(Coefficients<T>* c, const protocol::Matrix& m)
+{
+    Coefficients<T> r = *c;
+    T* first[] = { &r.n1, &r.d1 };
+    T* second[] = { &r.n0, &r.d0 };
+    if (!SubstituteTerms(m, first, second))
+    {
+        return false;
+    }
+    // Amplify doubles coefficients; keep them from piling up factors of two.
+    T* terms[] = { &r.n1, &r.n0, &r.d1, &r.d0 };
+    TakeOutTwos(terms);
+    *c = std::move(r);
+    tracelog("ingesting " << m.a << " " << m.b << " " << m.c << " " << m.d << " from " << _x
+             << ", new state " << c->n1 << " " << c->n0 << " " << c->d1 << " " << c->d0);
+    return true;
 }
 
 }  // namespace strategy
 }  // namespace clarith
 }  // namespace deepnum
-
@@ -21,6 +21,12 @@
 #ifndef SRC_STRATEGY_HOMOGRAPHY_HPP_
 #define SRC_STRATEGY_HOMOGRAPHY_HPP_
 
+#include <cstdint>
+#include <variant>
+
+#include "arithmetic/integer.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/matrix.hpp"
 #include "strategy.hpp"
 
 namespace deepnum
@@ -34,22 +40,100 @@ class Number;
 namespace strategy
 {
 
+class Cycle;
+
 /**
  * First degree homographic transformation.
  * This strategy accepts a Number \f$x\f$ as input and outputs
  * \f$y=\frac{n_1 x + n_0}{d_1 x + d_0}\f$ where
- * \f$n_1\f$, \f$n_0\f$, \f$d_1\f$ and \f$d_0\f$ are machine native signed integers.
+ * \f$n_1\f$, \f$n_0\f$, \f$d_1\f$ and \f$d_0\f$ are signed integers.
+ *
+ * Coefficients start as machine native integers. Whenever an update would
+ * overflow them, they are promoted to the next wider type (std::int64_t,
+ * then __int128, then arithmetic::Integer) and the update is retried.
+ *
+ * When the input is itself a Homography that has not egested yet,
+ * and either of the two is affine (\f$d_1=0\f$), both are folded into one
+ * at construction, provided the composed coefficients fit in an int.
+ * Messages then cross a single strategy instead of two.
+ * Otherwise the nested form is kept.
+ *
+ * When the value of the input is already known (strategy::Zero,
+ * strategy::Ratio, strategy::Ratio64 or an exhausted Homography of
+ * machine integers) and finite, the output is worked out at construction;
+ * the strategy is then exhausted from the start and degenerates to a ratio.
+ * Inputs at a pole are left to the general machinery, so they raise
+ * UndefinedRatioError only when egested, as usual.
+ *
+ * When the input is a periodic Playback stored in place, the state of the transformation
+ * is checked for cycles after every ingest (see Cycle). Once a state
+ * repeats, the output is known to be eventually periodic; the strategy is
+ * then exhausted, and hands over a periodic Playback of its output since
+ * the first occurrence of that state.
+ *
+ * When a TranspositionTable is installed at construction, transitions
+ * from one state to the next over runs of input messages are looked up
+ * in it, and cached on misses.
  * \see Strategy
  */
 class Homography : public Strategy
 {
  public:
 
+    /**
+     * Coefficients of the transformation.
+     * \tparam T Signed integer type.
+     */
+    template <typename T>
+    struct Coefficients
+    {
+        T n1, n0, d1, d0;
+    };
+
+    /**
+     * Coefficients in the narrowest type that holds them.
+     */
+    using State = std::variant<
+            Coefficients<int>,
+            Coefficients<std::int64_t>,
+            Coefficients<__int128>,
+            Coefficients<arithmetic::Integer>>;
+
+    /**
+     * When coefficients are divided by their greatest common divisor.
+     * Common factors build up over long inputs; dividing them out
+     * keeps coefficients narrow for longer.
+     */
+    enum class Reduction
+    {
+
+        /**
+         * Coefficients only shrink by halving on Protocol::Amplify.
+         */
+        Never,
+
+        /**
+         * Before promoting coefficients to a wider type.
+         */
+        OnOverflow,
+
+        /**
+         * After every ingested message.
+         */
+        Always,
+
+    };
+
     Homography(const Homography&) = delete;
     Homography& operator=(const Homography&) = delete;
-    Homography(Homography&&) = delete;
     Homography& operator=(Homography&&) = delete;
 
+    /**
+     * Takes over the state of other, which is left to be destroyed.
+     * This lets a Number holding the strategy in place move.
+     */
+    Homography(Homography&& other) noexcept;
+
     ~Homography();
 
     /**
@@ -58,30 +142,97 @@ class Homography : public Strategy
      * \param n0 Independent numerator coefficient.
      * \param d1 First order denominator coefficient.
      * \param d0 Independent denominator coefficient.
-     * \pre x not null.
+     * \param reduction Coefficient reduction policy.
+     * \pre x not null, and dynamically allocated.
      * \see strategy::Homography
      * \throws UndefinedRatioError
      */
-    Homography(gsl::owner<Number*> x, int n1, int n0, int d1, int d0);
+    Homography(gsl::owner<Number*> x, int n1, int n0, int d1, int d0,
+               Reduction reduction = Reduction::OnOverflow);
+
+    /**
+     * Number for \f$\frac{n_1 x + n_0}{d_1 x + d_0}\f$, defined by the
+     * lightest strategy that computes it:
+     * \f$x\f$ itself, or Negation, Reciprocation and Scaling when only the
+     * head of \f$x\f$ changes; Homography otherwise.
+     * The new numbers and strategies are allocated from the memory
+     * resource of \f$x\f$.
+     * \param x Input.
+     * \pre x not null, and dynamically allocated.
+     * \throws UndefinedRatioError
+     */
+    static gsl::owner<Number*> Make(gsl::owner<Number*> x, int n1, int n0, int d1, int d0);
 
-    protocol::Protocol Egest() override;
-    gsl::owner<Strategy*> GetNewStrategy() const override;
+    bool Egest(protocol::Protocol* message) override;
+
+    /**
+     * Extracts Protocol messages until more input is needed.
+     * \see Strategy::EgestMany
+     */
+    std::size_t EgestMany(protocol::Protocol* out, std::size_t max) override;
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override;
+    bool SucceedInto(Number* number) const override;
+
+    /**
+     * Output value once the strategy is exhausted.
+     * The output is the ratio of coefficients n0 and d0.
+     * \return Final coefficients.
+     * \throw UnavailableError
+     * \see GetNewStrategy
+     */
+    const State& GetResult() const;
+
+    /**
+     * Periodic output, once the strategy is exhausted by a cycle.
+     * \return Output over one period, that repeats forever after the
+     *         messages already egested; null if the output is a ratio.
+     * \throw UnavailableError
+     * \see GetNewStrategy
+     */
+    const protocol::Buffer* GetPeriod() const;
 
  private:
 
-    void DetectOutputRange(int* min_n, int* min_d, int* max_n, int* max_d);
-    static protocol::Protocol CanEgest(int min_n, int min_d, int max_n, int max_d);
-    static bool IsBetweenZeroAndOne(int n, int d);
-    static void MinMax(int* min_n, int* min_d, int* max_n, int* max_d, int n, int d);
-    protocol::Protocol Egest(protocol::Protocol output);
-    static int Compare(int n1, int d1, int n2, int d2);
-    void Ingest();
+    enum class Step { Full, NeedInput, Point, Overflow };
+
+    // Transition being recorded for, or replayed from, the transposition table.
+    struct Transition;
+
+    std::size_t Run(protocol::Protocol* out, std::size_t max);
+    template <typename T>
+    Step EgestMany(Coefficients<T>* c, protocol::Protocol* out, std::size_t max, std::size_t* count);
+    template <typename T>
+    static bool HasRootBetweenZeroAndOne(const T& a1, const T& a0);
+    template <typename T>
+    bool Egest(Coefficients<T>* c, protocol::Protocol output);
+    template <typename T>
+    bool Substitute(Coefficients<T>* c, const protocol::Matrix& m);
+    bool Ingest();
+    bool Apply(const protocol::Protocol* block, std::size_t count);
+    bool Transpose(const protocol::Protocol* block, std::size_t count);
+    void Remember(const protocol::Protocol* out, std::size_t count);
+    void Settle();
+    std::size_t Replay(protocol::Protocol* out, std::size_t max);
+    bool Repeats();
+    void Compose();
+    void Evaluate();
+    void MakeRoom();
+    bool Reduce();
+    void Promote();
 
     Number* _x;
-    int _n1, _n0, _d1, _d0;
+    State _state;
+    Reduction _reduction;
     bool _primed;
     bool _exhausted;
     bool _has_pole;
+    bool _pole_in_range;
+    bool _constant;
+    // Created when the input turns out to be periodic.
+    Cycle* _cycle;
+    bool _periodic;
+    // Created when a transposition table is installed.
+    Transition* _transition;
 };
 
 }  // namespace strategy
@@ -18,9 +18,13 @@
  * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
  */
 
+#include <utility>
+
+#include "number.hpp"
 #include "protocol/protocol.hpp"
+#include "protocol/violation_error.hpp"
+#include "raise.hpp"
 #include "strategy/zero.hpp"
-#include "strategy/exhaustion_error.hpp"
 #include "strategy/unavailable_error.hpp"
 
 #include "playback.hpp"
@@ -37,7 +41,8 @@ namespace strategy
 {
 
 Playback::Playback(gsl::owner<std::forward_list<protocol::Protocol>*> sequence)
-        : sequence_(sequence)
+        : sequence_(sequence),
+          source_(nullptr)
 {
     tracelog(sequence);
     if (!sequence_)
@@ -46,31 +51,150 @@ Playback::Playback(gsl::owner<std::forward_list<protocol::Protocol>*> sequence)
     }
 }
 
+Playback::Playback(protocol::Buffer sequence)
+        : sequence_(nullptr),
+          buffer_(std::move(sequence)),
+          source_(&buffer_)
+{
+    tracelog("buffer of " << buffer_.Size());
+}
+
+Playback::Playback(const protocol::Buffer* sequence)
+        : sequence_(nullptr),
+          source_(sequence)
+{
+    tracelog("shared buffer " << sequence << " of " << source_->Size());
+}
+
+Playback::Playback(protocol::Buffer sequence, std::size_t loop)
+        : sequence_(nullptr),
+          buffer_(std::move(sequence)),
+          source_(&buffer_),
+          loop_(loop),
+          periodic_(true)
+{
+    tracelog("buffer of " << buffer_.Size() << " looping at " << loop);
+    if (buffer_.IsTerminated())
+    {
+        Raise<protocol::ViolationError>("forbidden non final '0'");
+    }
+    if (!loop_ && buffer_[0] != Protocol::Amplify && buffer_[0] != Protocol::Uncover)
+    {
+        Raise<protocol::ViolationError>("forbidden periodic head");
+    }
+}
+
+Playback::Playback(Playback&& other) noexcept
+        : Strategy(std::move(other)),
+          sequence_(std::exchange(other.sequence_, nullptr)),
+          watcher_(std::move(other.watcher_)),
+          buffer_(std::move(other.buffer_)),
+          // Packed sequences of our own move along.
+          source_(other.source_ == &other.buffer_ ? &buffer_ : other.source_),
+          position_(other.position_),
+          loop_(other.loop_),
+          periodic_(other.periodic_)
+{
+    tracelog(&other);
+}
+
 Playback::~Playback()
 {
     tracelog("");
     delete sequence_;
 }
 
-Protocol Playback::Egest()
+bool Playback::Egest(Protocol* message)
 {
+    if (!sequence_)
+    {
+        // Packed sequences are validated as they are built, but for their implicit end.
+        if (position_ == source_->Size())
+        {
+            if (!periodic_)
+            {
+                CheckImplicitEnd();
+                return false;
+            }
+            position_ = loop_;
+        }
+        *message = (*source_)[position_++];
+        return true;
+    }
     if (sequence_->empty())
     {
         watcher_.Watch(Protocol::End);
-        throw ExhaustionError();
+        return false;
     }
     Protocol answer = sequence_->front();
     sequence_->pop_front();
-    return watcher_.Watch(answer);
+    *message = watcher_.Watch(answer);
+    return true;
 }
 
-gsl::owner<Strategy*> Playback::GetNewStrategy() const
+std::size_t Playback::EgestMany(Protocol* out, std::size_t max)
 {
-    if (!sequence_->empty())
+    if (!sequence_)
+    {
+        std::size_t count = source_->Read(position_, out, max);
+        position_ += count;
+        while (periodic_ && count < max)
+        {
+            std::size_t run = source_->Read(loop_, out + count, max - count);
+            position_ = loop_ + run;
+            count += run;
+        }
+        if (!count && max)
+        {
+            CheckImplicitEnd();
+        }
+        return count;
+    }
+    std::size_t count = 0;
+    while (count < max && Playback::Egest(out + count))
     {
-        throw UnavailableError();
+        ++count;
     }
-    return new Zero();
+    return count;
+}
+
+gsl::owner<Strategy*> Playback::GetNewStrategy(std::pmr::memory_resource* resource) const
+{
+    CheckEnded();
+    return new (resource) Zero();
+}
+
+bool Playback::SucceedInto(Number* number) const
+{
+    CheckEnded();
+    Succeed<Zero>(number);
+    return true;
+}
+
+void Playback::CheckImplicitEnd() const
+{
+    if (!source_->IsTerminated() && position_ && (*source_)[position_ - 1] == Protocol::Amplify)
+    {
+        Raise<protocol::ViolationError>("forbidden '20' sequence");
+    }
+}
+
+void Playback::CheckEnded() const
+{
+    if (periodic_ || (sequence_ ? !sequence_->empty() : position_ != source_->Size()))
+    {
+        Raise<UnavailableError>();
+    }
+}
+
+bool Playback::IsPeriodic() const
+{
+    return periodic_;
+}
+
+std::size_t Playback::Position() const
+{
+    return periodic_ && position_ == source_->Size() ? loop_ : position_;
 }
 
 }  // namespace strategy
@@ -21,7 +21,9 @@
 #ifndef SRC_STRATEGY_PLAYBACK_HPP_
 #define SRC_STRATEGY_PLAYBACK_HPP_
 
+#include <cstddef>
 #include <forward_list>
+#include "protocol/buffer.hpp"
 #include "protocol/watcher.hpp"
 #include "strategy.hpp"
 
@@ -41,6 +43,13 @@ namespace strategy
 /**
  * Protocol sequence.
  * This strategy defines a Number by means of its Protocol sequence.
+ *
+ * Packed sequences (protocol::Buffer) are read through a cursor and never
+ * modified, so that a single sequence can be shared by any number of
+ * Playback instances.
+ * A packed sequence can also be replayed periodically, for numbers whose
+ * Protocol sequence is eventually periodic, such as the outputs of
+ * Homography that repeat their state.
  * \see Strategy
  */
 class Playback : public Strategy
@@ -49,9 +58,14 @@ class Playback : public Strategy
 
     Playback(const Playback&) = delete;
     Playback& operator=(const Playback&) = delete;
-    Playback(Playback&&) = delete;
     Playback& operator=(Playback&&) = delete;
 
+    /**
+     * Takes over the state of other, which is left to be destroyed.
+     * This lets a Number holding the strategy in place move.
+     */
+    Playback(Playback&& other) noexcept;
+
     virtual ~Playback();
 
     /**
@@ -62,16 +76,78 @@ class Playback : public Strategy
      */
     explicit Playback(gsl::owner<std::forward_list<protocol::Protocol>*> sequence);
 
+    /**
+     * Playback strategy constructor.
+     * Construct a reducing strategy from a packed sequence of messages,
+     * such as the one obtained by Util::ToBuffer.
+     * \param[in] sequence Protocol message sequence.
+     */
+    explicit Playback(protocol::Buffer sequence);
+
+    /**
+     * Playback strategy constructor.
+     * Construct a reducing strategy that replays a packed sequence of
+     * messages owned by someone else.
+     * \param[in] sequence Protocol message sequence.
+     * \pre sequence is not null, and outlives this strategy.
+     */
+    explicit Playback(const protocol::Buffer* sequence);
+
+    /**
+     * Playback strategy constructor.
+     * Construct a strategy that never reduces: it plays a packed sequence of
+     * messages, then repeats it from a given position on, forever.
+     * \param[in] sequence Protocol message sequence: prefix then period.
+     * \param[in] loop Position where the period starts.
+     * \pre loop is lesser than the size of sequence.
+     * \throw protocol::ViolationError if the sequence is terminated, or if
+     *        the period starts with a head message, which would then appear
+     *        again after the first one.
+     */
+    Playback(protocol::Buffer sequence, std::size_t loop);
+
     /**
      * \throw protocol::ViolationError
      */
-    protocol::Protocol Egest() override;
+    bool Egest(protocol::Protocol* message) override;
+    std::size_t EgestMany(protocol::Protocol* out, std::size_t max) override;
+
+    /**
+     * \throw UnavailableError if playing periodically.
+     */
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override;
 
-    gsl::owner<Strategy*> GetNewStrategy() const override;
+    /**
+     * \throw UnavailableError if playing periodically.
+     */
+    bool SucceedInto(Number* number) const override;
+
+    /**
+     * \return Is the sequence repeated forever?
+     */
+    bool IsPeriodic() const;
+
+    /**
+     * Position of the next message in the packed sequence.
+     * Periodic playbacks are back at the same position whenever their
+     * output repeats.
+     * \pre Playing a packed sequence.
+     */
+    std::size_t Position() const;
 
  private:
+    void CheckImplicitEnd() const;
+    void CheckEnded() const;
+
+    // Null when playing a packed sequence.
     std::forward_list<protocol::Protocol>* sequence_;
     protocol::Watcher watcher_;
+    protocol::Buffer buffer_;
+    const protocol::Buffer* source_;
+    std::size_t position_ { 0 };
+    // Where periodic playbacks go back to when reaching the end of sequence.
+    std::size_t loop_ { 0 };
+    bool periodic_ { false };
 };
 
 }  // namespace strategy
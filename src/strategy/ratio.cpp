@@ -18,9 +18,15 @@
  * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
  */
 
-#include "exhaustion_error.hpp"
+#include <algorithm>
+#include <cstdint>
+
 #include "zero.hpp"
+#include "arithmetic/bits.hpp"
+#include "arithmetic/integer.hpp"
+#include "number.hpp"
 #include "protocol/protocol.hpp"
+#include "raise.hpp"
 #include "unavailable_error.hpp"
 #include "undefined_ratio_error.hpp"
 
@@ -28,6 +34,8 @@
 
 #include "tracelog.h"
 
+using deepnum::clarith::arithmetic::BitLength;
+using deepnum::clarith::arithmetic::CountTrailingZeros;
 using deepnum::clarith::protocol::Protocol;
 
 namespace deepnum
@@ -37,19 +45,34 @@ namespace clarith
 namespace strategy
 {
 
-Ratio::~Ratio()
+namespace
+{
+
+// Magnitude of a signed integer, without overflow on the lowest value.
+template <typename S, typename U>
+U Magnitude(S x)
+{
+    return x >= 0 ? U(x) : U(0) - U(x);
+}
+
+}  // namespace
+
+template <typename S, typename U>
+BasicRatio<S, U>::~BasicRatio()
 {
     tracelog("");
 }
 
-Ratio::Ratio(int num, int den)
-        : Ratio(num >= 0 ? num : -num, den >= 0 ? den : -den,
+template <typename S, typename U>
+BasicRatio<S, U>::BasicRatio(S num, S den)
+        : BasicRatio(Magnitude<S, U>(num), Magnitude<S, U>(den),
                 (num >= 0 && den >= 0) || (num < 0 && den < 0))
 {
     tracelog(num << " " << den);
 }
 
-Ratio::Ratio(unsigned int num, unsigned int den, bool positive)
+template <typename S, typename U>
+BasicRatio<S, U>::BasicRatio(U num, U den, bool positive)
         : num_(num),
           den_(den),
           positive_(positive)
@@ -57,17 +80,36 @@ Ratio::Ratio(unsigned int num, unsigned int den, bool positive)
     tracelog(num << " " << den << " " << positive);
     if (num_ == 0 && den_ == 0)
     {
-        throw UndefinedRatioError();
+        Raise<UndefinedRatioError>();
     }
 }
 
-Protocol Ratio::Egest()
+template <typename S, typename U>
+const U& BasicRatio<S, U>::Numerator() const
+{
+    return num_;
+}
+
+template <typename S, typename U>
+const U& BasicRatio<S, U>::Denominator() const
+{
+    return den_;
+}
+
+template <typename S, typename U>
+bool BasicRatio<S, U>::IsPositive() const
+{
+    return positive_;
+}
+
+template <typename S, typename U>
+bool BasicRatio<S, U>::Egest(Protocol* message)
 {
     Protocol answer;
     if (num_ == 0)
     {
         tracelog("end of data");
-        throw ExhaustionError();
+        return false;
     }
     if (!positive_)
     {
@@ -108,18 +150,94 @@ Protocol Ratio::Egest()
     answer = Protocol::Amplify;
 egest_end:
     tracelog("egesting " << answer << ", new state " << num_ << " " << den_ << " " << positive_);
-    return answer;
+    *message = answer;
+    return true;
+}
+
+template <typename S, typename U>
+std::size_t BasicRatio<S, U>::EgestMany(Protocol* out, std::size_t max)
+{
+    std::size_t count = 0;
+    while (count < max)
+    {
+        if (positive_ && num_ && num_ <= den_ / 2)
+        {
+            unsigned int run = AmplifyRun();
+            if (run > max - count)
+            {
+                run = max - count;
+            }
+            std::fill_n(out + count, run, Protocol::Amplify);
+            Amplify(run);
+            count += run;
+            continue;
+        }
+        if (!BasicRatio::Egest(out + count))
+        {
+            break;
+        }
+        ++count;
+    }
+    return count;
 }
 
-gsl::owner<Strategy*> Ratio::GetNewStrategy() const
+template <typename S, typename U>
+unsigned int BasicRatio<S, U>::AmplifyRun() const
+{
+    /*
+     * Amplify is egested while num/den is no greater than one half,
+     * so the run length is the greatest k such that num*2^k <= den.
+     * Aligning the most significant bits of num and den gives
+     * either k or k+1.
+     */
+    unsigned int run = BitLength(den_) - BitLength(num_);
+    if (num_ << run > den_)
+    {
+        --run;
+    }
+    return run;
+}
+
+template <typename S, typename U>
+void BasicRatio<S, U>::Amplify(unsigned int run)
+{
+    // Same as repeating Egest: halve den while it is even, then double num.
+    unsigned int halvings = CountTrailingZeros(den_);
+    if (halvings > run)
+    {
+        halvings = run;
+    }
+    den_ >>= halvings;
+    num_ <<= run - halvings;
+    tracelog("amplified " << run << " times, new state " << num_ << " " << den_ << " " << positive_);
+}
+
+template <typename S, typename U>
+gsl::owner<Strategy*> BasicRatio<S, U>::GetNewStrategy(std::pmr::memory_resource* resource) const
+{
+    if (num_ != 0)
+    {
+        Raise<UnavailableError>();
+    }
+    return new (resource) Zero();
+}
+
+template <typename S, typename U>
+bool BasicRatio<S, U>::SucceedInto(Number* number) const
 {
     if (num_ != 0)
     {
-        throw UnavailableError();
+        Raise<UnavailableError>();
     }
-    return new Zero();
+    Succeed<Zero>(number);
+    return true;
 }
 
+template class BasicRatio<int, unsigned int>;
+template class BasicRatio<std::int64_t, std::uint64_t>;
+template class BasicRatio<__int128, unsigned __int128>;
+template class BasicRatio<arithmetic::Integer, arithmetic::Integer>;
+
 }  // namespace strategy
 }  // namespace clarith
 }  // namespace deepnum
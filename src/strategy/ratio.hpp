@@ -21,6 +21,10 @@
 #ifndef SRC_STRATEGY_RATIO_HPP_
 #define SRC_STRATEGY_RATIO_HPP_
 
+#include <cstddef>
+#include <cstdint>
+
+#include "arithmetic/integer.hpp"
 #include "strategy.hpp"
 
 namespace deepnum
@@ -39,18 +43,21 @@ namespace strategy
 /**
  * Integer ratio.
  * This strategy can reduce ratios of integer numbers.
- * \see Strategy
+ * \tparam S Signed integer type.
+ * \tparam U Unsigned counterpart of S.
+ * \see Strategy, Ratio, Ratio64, Ratio128, BigRatio
  */
-class Ratio : public Strategy
+template <typename S, typename U>
+class BasicRatio : public Strategy
 {
  public:
 
-    Ratio(const Ratio&) = delete;
-    Ratio& operator=(const Ratio&) = delete;
-    Ratio(Ratio&&) = delete;
-    Ratio& operator=(Ratio&&) = delete;
+    BasicRatio(const BasicRatio&) = delete;
+    BasicRatio& operator=(const BasicRatio&) = delete;
+    BasicRatio(BasicRatio&&) = default;
+    BasicRatio& operator=(BasicRatio&&) = delete;
 
-    virtual ~Ratio();
+    virtual ~BasicRatio();
 
     /**
      * Ratio strategy constructor.
@@ -60,7 +67,7 @@ class Ratio : public Strategy
      * \pre num and den are not both zero.
      * \throw UndefinedRatioError
      */
-    Ratio(int num, int den);
+    BasicRatio(S num, S den);
 
     /**
      * Ratio strategy constructor.
@@ -71,17 +78,92 @@ class Ratio : public Strategy
      * \pre num and den are not both zero.
      * \throw UndefinedRatioError
      */
-    Ratio(unsigned int num, unsigned int den, bool positive);
+    BasicRatio(U num, U den, bool positive);
+
+    bool Egest(protocol::Protocol* message) override;
+
+    /**
+     * Extracts several Protocol messages at once.
+     * Runs of protocol::Protocol::Amplify are worked out in one step.
+     * \see Strategy::EgestMany
+     */
+    std::size_t EgestMany(protocol::Protocol* out, std::size_t max) override;
+
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override;
+    bool SucceedInto(Number* number) const override;
+
+    /**
+     * The value not egested yet is \f$\pm\frac{num}{den}\f$.
+     * \return Magnitude of the numerator.
+     * \see Denominator, IsPositive
+     */
+    const U& Numerator() const;
 
-    protocol::Protocol Egest() override;
-    gsl::owner<Strategy*> GetNewStrategy() const override;
+    /**
+     * \return Magnitude of the denominator.
+     * \see Numerator
+     */
+    const U& Denominator() const;
+
+    /**
+     * \return Is the value not egested yet positive?
+     * \see Numerator
+     */
+    bool IsPositive() const;
 
  protected:
-    unsigned int num_;
-    unsigned int den_;
+    unsigned int AmplifyRun() const;
+    void Amplify(unsigned int run);
+
+    U num_;
+    U den_;
     bool positive_;
 };
 
+/**
+ * Ratio of machine native integers.
+ */
+using Ratio = BasicRatio<int, unsigned int>;
+
+/**
+ * Ratio of 64 bit integers.
+ */
+using Ratio64 = BasicRatio<std::int64_t, std::uint64_t>;
+
+/**
+ * Ratio of 128 bit integers.
+ */
+using Ratio128 = BasicRatio<__int128, unsigned __int128>;
+
+/**
+ * Ratio of arbitrary precision integers.
+ */
+using BigRatio = BasicRatio<arithmetic::Integer, arithmetic::Integer>;
+
+/**
+ * Ratio strategy of a signed integer type.
+ * \tparam S One of int, std::int64_t, __int128 or arithmetic::Integer.
+ */
+template <typename S>
+struct RatioOf;
+
+template <>
+struct RatioOf<int> { using type = Ratio; };
+
+template <>
+struct RatioOf<std::int64_t> { using type = Ratio64; };
+
+template <>
+struct RatioOf<__int128> { using type = Ratio128; };
+
+template <>
+struct RatioOf<arithmetic::Integer> { using type = BigRatio; };
+
+extern template class BasicRatio<int, unsigned int>;
+extern template class BasicRatio<std::int64_t, std::uint64_t>;
+extern template class BasicRatio<__int128, unsigned __int128>;
+extern template class BasicRatio<arithmetic::Integer, arithmetic::Integer>;
+
 }  // namespace strategy
 }  // namespace clarith
 }  // namespace deepnum
@@ -0,0 +1,303 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "number.hpp"
+#include "protocol/matrix.hpp"
+#include "raise.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/unavailable_error.hpp"
+#include "strategy/undefined_ratio_error.hpp"
+
+#include "rewrite.hpp"
+
+#include "tracelog.h"
+
+using deepnum::clarith::protocol::Protocol;
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+Rewrite::Rewrite(Number* x)
+        : _x(x),
+        _rewritten(false),
+        _size(0),
+        _position(0),
+        _amplify(0),
+        _amplify_at(0)
+{
+    tracelog(x);
+}
+
+Rewrite::~Rewrite()
+{
+    tracelog("");
+    delete _x;
+}
+
+bool Rewrite::Egest(Protocol* message)
+{
+    return Rewrite::EgestMany(message, 1);
+}
+
+std::size_t Rewrite::EgestMany(Protocol* out, std::size_t max)
+{
+    if (!_rewritten)
+    {
+        _rewritten = true;
+        RewriteHead();
+    }
+    std::size_t count = 0;
+    while (count < max && (_amplify || _position < _size))
+    {
+        if (_amplify && _position == _amplify_at)
+        {
+            auto run = static_cast<unsigned int>(std::min<std::size_t>(_amplify, max - count));
+            std::fill_n(out + count, run, Protocol::Amplify);
+            _amplify -= run;
+            count += run;
+            continue;
+        }
+        if ((out[count++] = _queue[_position++]) == Protocol::End)
+        {
+            // The input ended while rewriting.
+            return count;
+        }
+    }
+    if (count < max)
+    {
+        count += _x->EgestMany(out + count, max - count);
+    }
+    return count;
+}
+
+gsl::owner<Strategy*> Rewrite::GetNewStrategy(std::pmr::memory_resource* /* resource */) const
+{
+    Raise<UnavailableError>();
+}
+
+Protocol Rewrite::Next()
+{
+    return _x->Egest();
+}
+
+void Rewrite::Push(Protocol message)
+{
+    tracelog(message);
+    _queue[_size++] = message;
+}
+
+void Rewrite::PushAmplify(unsigned int count)
+{
+    tracelog(count);
+    _amplify = count;
+    _amplify_at = _size;
+}
+
+void Rewrite::Transform(int n1, int n0, int d1, int d0)
+{
+    tracelog(n1 << " " << n0 << " " << d1 << " " << d0);
+    _x = new (GetResource(_x)) Number(std::in_place_type<Homography>, _x, n1, n0, d1, d0);
+}
+
+Negation::Negation(Number* x)
+        : Rewrite(x)
+{
+}
+
+void Negation::RewriteHead()
+{
+    Protocol first = Next();
+    switch (first)
+    {
+        case Protocol::Turn:
+            Push(Protocol::Ground);
+            break;
+        case Protocol::Ground:
+            Push(Protocol::Turn);
+            break;
+        case Protocol::Reflect:
+            break;
+        case Protocol::End:
+            Push(Protocol::End);
+            break;
+        default:
+            Push(Protocol::Reflect);
+            Push(first);
+    }
+}
+
+Reciprocation::Reciprocation(Number* x)
+        : Rewrite(x)
+{
+}
+
+void Reciprocation::RewriteHead()
+{
+    Protocol first = Next();
+    switch (first)
+    {
+        case Protocol::End:
+            Raise<UndefinedRatioError>();
+        case Protocol::Turn:
+            break;
+        case Protocol::Ground:
+            Push(Protocol::Reflect);
+            break;
+        case Protocol::Amplify:
+            Push(Protocol::Turn);
+            Push(first);
+            break;
+        case Protocol::Uncover:
+        {
+            // Only one is its own reciprocal.
+            Protocol second = Next();
+            if (second != Protocol::End)
+            {
+                Push(Protocol::Turn);
+            }
+            Push(first);
+            Push(second);
+            break;
+        }
+        case Protocol::Reflect:
+        {
+            // So is minus one.
+            Protocol second = Next();
+            if (second != Protocol::Uncover)
+            {
+                Push(Protocol::Ground);
+                Push(second);
+                break;
+            }
+            Protocol third = Next();
+            Push(third == Protocol::End ? Protocol::Reflect : Protocol::Ground);
+            Push(second);
+            Push(third);
+            break;
+        }
+    }
+}
+
+Scaling::Scaling(Number* x, int exponent)
+        : Rewrite(x),
+        _exponent(exponent)
+{
+}
+
+void Scaling::RewriteHead()
+{
+    Protocol head = Next();
+    if (head == Protocol::End)
+    {
+        Push(Protocol::End);
+        return;
+    }
+    bool has_head = head == Protocol::Turn || head == Protocol::Reflect || head == Protocol::Ground;
+    bool reciprocal = head == Protocol::Turn || head == Protocol::Ground;
+    Protocol message = has_head ? Next() : head;
+    if (message == Protocol::End)
+    {
+        // Infinity (or zero after a sign) is its own scaling.
+        Push(head);
+        Push(message);
+        return;
+    }
+    // What follows a reciprocal head scales the other way round.
+    long long shift = reciprocal ? -static_cast<long long>(_exponent) : _exponent;
+    if (shift <= 0)
+    {
+        // Makes the input smaller in magnitude; amplify what follows the head.
+        if (has_head)
+        {
+            Push(head);
+        }
+        PushAmplify(static_cast<unsigned int>(-shift));
+        Push(message);
+        return;
+    }
+    // Makes the input larger in magnitude; drop leading amplifies.
+    long long dropped = 0;
+    while (dropped < shift && message == Protocol::Amplify)
+    {
+        ++dropped;
+        message = Next();
+    }
+    if (dropped == shift)
+    {
+        if (!reciprocal || message != Protocol::Uncover)
+        {
+            if (has_head)
+            {
+                Push(head);
+            }
+            Push(message);
+            return;
+        }
+        // One in magnitude has no reciprocal head.
+        Protocol next = Next();
+        if (next != Protocol::End)
+        {
+            Push(head);
+        }
+        else if (head == Protocol::Ground)
+        {
+            Push(Protocol::Reflect);
+        }
+        Push(message);
+        Push(next);
+        return;
+    }
+    /*
+     * The output crosses one in magnitude. The input is now H(1/(x+1)),
+     * where x is what follows Protocol::Uncover and H undoes the head;
+     * the output is that scaled by what remains of the power of two.
+     */
+    tracelog("output crosses one in magnitude");
+    protocol::Matrix m = protocol::InputMatrix(message);
+    if (has_head)
+    {
+        m = protocol::InputMatrix(head) * m;
+    }
+    Transform(m.a, m.b, m.c, m.d);
+    constexpr long long kMaxShift = 30;
+    for (long long left = shift - dropped; left > 0; left -= kMaxShift)
+    {
+        int factor = 1 << std::min(left, kMaxShift);
+        if (_exponent > 0)
+        {
+            Transform(factor, 0, 0, 1);
+        }
+        else
+        {
+            Transform(1, 0, 0, factor);
+        }
+    }
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
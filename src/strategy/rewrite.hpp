@@ -0,0 +1,193 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_STRATEGY_REWRITE_HPP_
+#define SRC_STRATEGY_REWRITE_HPP_
+
+#include <cstddef>
+
+#include "protocol/protocol.hpp"
+#include "strategy.hpp"
+
+namespace deepnum
+{
+
+namespace clarith
+{
+
+class Number;
+
+namespace strategy
+{
+
+/**
+ * Transformation that only rewrites the first messages of its input.
+ * Once the head of the input is rewritten, the rest of the input is
+ * passed through untouched, with no arithmetic per message;
+ * this is much lighter than an equivalent Homography.
+ * \see Negation, Reciprocation, Scaling, Strategy
+ */
+class Rewrite : public Strategy
+{
+ public:
+
+    Rewrite(const Rewrite&) = delete;
+    Rewrite& operator=(const Rewrite&) = delete;
+    Rewrite(Rewrite&&) = delete;
+    Rewrite& operator=(Rewrite&&) = delete;
+
+    ~Rewrite();
+
+    bool Egest(protocol::Protocol* message) override;
+    std::size_t EgestMany(protocol::Protocol* out, std::size_t max) override;
+
+    /**
+     * Rewrites are never exhausted; their input ends them.
+     * \throw UnavailableError
+     */
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override;
+
+ protected:
+
+    /**
+     * \param x Input.
+     * \pre x not null, and dynamically allocated.
+     */
+    explicit Rewrite(gsl::owner<Number*> x);
+
+    /**
+     * Rewrites the head of the input, before the first egest.
+     * Takes messages from the input with Next, and tells what to output
+     * in their place with Push and PushAmplify.
+     */
+    virtual void RewriteHead() = 0;
+
+    /**
+     * \return Next message of the input.
+     */
+    protocol::Protocol Next();
+
+    /**
+     * Queues a message for output.
+     * At most three messages can be queued.
+     */
+    void Push(protocol::Protocol message);
+
+    /**
+     * Queues a run of Protocol::Amplify messages for output.
+     * \param[in] count Length of the run.
+     */
+    void PushAmplify(unsigned int count);
+
+    /**
+     * Replaces the input \f$x\f$ by \f$\frac{n_1x+n_0}{d_1x+d_0}\f$,
+     * for inputs whose head cannot be simply rewritten.
+     * The new input is allocated from the memory resource of \f$x\f$.
+     */
+    void Transform(int n1, int n0, int d1, int d0);
+
+ private:
+
+    static constexpr std::size_t kMaxQueue = 3;
+
+    Number* _x;
+    bool _rewritten;
+    protocol::Protocol _queue[kMaxQueue];
+    std::size_t _size;
+    std::size_t _position;
+    // Amplify messages to output when reaching position _amplify_at of the queue.
+    unsigned int _amplify;
+    std::size_t _amplify_at;
+};
+
+/**
+ * Negation.
+ * This strategy outputs \f$-x\f$ by rewriting the first message of \f$x\f$.
+ * \see Rewrite
+ */
+class Negation : public Rewrite
+{
+ public:
+
+    /**
+     * \param x Input.
+     * \pre x not null.
+     */
+    explicit Negation(gsl::owner<Number*> x);
+
+ private:
+
+    void RewriteHead() override;
+};
+
+/**
+ * Reciprocal.
+ * This strategy outputs \f$1/x\f$ by rewriting the first message of \f$x\f$,
+ * looking a couple of messages ahead to tell whether \f$|x|\f$ is one.
+ * \see Rewrite
+ * \throws UndefinedRatioError if x is zero.
+ */
+class Reciprocation : public Rewrite
+{
+ public:
+
+    /**
+     * \param x Input.
+     * \pre x not null.
+     */
+    explicit Reciprocation(gsl::owner<Number*> x);
+
+ private:
+
+    void RewriteHead() override;
+};
+
+/**
+ * Scaling by a power of two.
+ * This strategy outputs \f$2^kx\f$ by adding or removing Protocol::Amplify
+ * messages after the head of \f$x\f$.
+ * When this pushes the output across one in magnitude, the output head
+ * changes in a way that cannot be rewritten; the input is then
+ * transformed by a Homography.
+ * \see Rewrite
+ */
+class Scaling : public Rewrite
+{
+ public:
+
+    /**
+     * \param x Input.
+     * \param exponent Power of two k.
+     * \pre x not null.
+     */
+    Scaling(gsl::owner<Number*> x, int exponent);
+
+ private:
+
+    void RewriteHead() override;
+
+    int _exponent;
+};
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_STRATEGY_REWRITE_HPP_
@@ -1,5 +1,5 @@
 /*
- * Copyright 2018 Rafael Lorandi <coolparadox@gmail.com>
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
  *
  * This file is part of dn-clarith, a library for performing arithmetic
  * in continued logarithm representation.
@@ -18,10 +18,14 @@
  * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
  */
 
-#ifndef SRC_STRATEGY_EXHAUSTION_ERROR_HPP_
-#define SRC_STRATEGY_EXHAUSTION_ERROR_HPP_
 
-#include <stdexcept>
+#include "protocol/protocol.hpp"
+
+#include "strategy.hpp"
+
+#include "tracelog.h"
+
+using deepnum::clarith::protocol::Protocol;
 
 namespace deepnum
 {
@@ -30,18 +34,22 @@ namespace clarith
 namespace strategy
 {
 
-/**
- * Indicates that a reducing strategy is no longer effective.
- * \see Strategy::Egest
- */
-class ExhaustionError : public std::runtime_error
+std::size_t Strategy::EgestMany(Protocol* out, std::size_t max)
 {
- public:
-    ExhaustionError();
-};
+    std::size_t count = 0;
+    while (count < max && Egest(out + count))
+    {
+        ++count;
+    }
+    tracelog("egested " << count << " messages");
+    return count;
+}
+
+bool Strategy::SucceedInto(Number* /* number */) const
+{
+    return false;
+}
 
 }  // namespace strategy
 }  // namespace clarith
 }  // namespace deepnum
-
-#endif  // SRC_STRATEGY_EXHAUSTION_ERROR_HPP_
@@ -21,14 +21,20 @@
 #ifndef SRC_STRATEGY_STRATEGY_HPP_
 #define SRC_STRATEGY_STRATEGY_HPP_
 
+#include <cstddef>
+#include <memory_resource>
 #include <gsl/gsl>
 
+#include "allocatable.hpp"
+
 namespace deepnum
 {
 
 namespace clarith
 {
 
+class Number;
+
 namespace protocol
 {
 enum class Protocol;
@@ -41,7 +47,7 @@ namespace strategy
  * Represents an approach for reducing numbers to Protocol message sequences.
  * \see Protocol
  */
-class Strategy
+class Strategy : public Allocatable
 {
  public:
 
@@ -49,28 +55,72 @@ class Strategy
     virtual ~Strategy() = default;
     Strategy(const Strategy&) = delete;
     Strategy& operator=(const Strategy&) = delete;
-    Strategy(Strategy&&) = delete;
     Strategy& operator=(Strategy&&) = delete;
 
     /**
      * Extracts next Protocol message.
      * Takes out the next Protocol message from the underlying strategy,
      * which loses this information as a side effect.
-     * \return Extracted Protocol message.
-     * \throw ExhaustionError
+     * \param[out] message Extracted Protocol message.
+     * \return false if the strategy is exhausted (message is left untouched),
+     *         true otherwise.
      * \see GetNewStrategy
      */
-    virtual protocol::Protocol Egest() = 0;
+    virtual bool Egest(protocol::Protocol* message) = 0;
+
+    /**
+     * Extracts several Protocol messages at once.
+     * Takes out as many Protocol messages as the strategy can readily
+     * produce, up to a maximum.
+     * The default implementation repeats Egest(protocol::Protocol*).
+     * \param[out] out Extracted Protocol messages.
+     * \param[in] max Maximum number of messages to extract.
+     * \return Number of extracted messages;
+     *         0 if the strategy is exhausted (and max is not 0).
+     * \see Egest
+     */
+    virtual std::size_t EgestMany(protocol::Protocol* out, std::size_t max);
 
     /**
      * New strategy in case of exhaustion.
      * Offers another strategy that can resume the reduction process
      * in case the current strategy ceases working.
-     * \return New strategy where Egest() works.
+     * \param[in] resource Where to allocate the new strategy from.
+     * \return New strategy where Egest(protocol::Protocol*) works.
      * \throw UnavailableError
      * \see Egest
      */
-    virtual gsl::owner<Strategy*> GetNewStrategy() const = 0;
+    virtual gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const = 0;
+
+    /**
+     * Stores the new strategy in place in a number, in case of exhaustion.
+     * Number tries this before GetNewStrategy, which saves allocating the
+     * new strategy when it is a library one; strategies whose
+     * GetNewStrategy returns a library strategy should override both.
+     * The default implementation stores nothing.
+     * \param[in,out] number Number whose strategy is this one. When this
+     *                strategy is stored in place, storing the new one destroys it.
+     * \return Was the new strategy stored?
+     * \throw UnavailableError
+     * \see GetNewStrategy
+     */
+    virtual bool SucceedInto(Number* number) const;
+
+ protected:
+
+    /**
+     * Replaces the strategy of a number by a new one of type S, stored in
+     * place. Defined in number.hpp.
+     * \param[in,out] number Number to replace the strategy of.
+     * \param[in] args Constructor arguments, that may refer to the current strategy.
+     */
+    template <typename S, typename... Args>
+    static void Succeed(Number* number, Args&&... args);
+
+    /**
+     * Strategies stored in place move along with their Number.
+     */
+    Strategy(Strategy&&) = default;
 };
 
 }  // namespace strategy
@@ -0,0 +1,353 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_STRATEGY_TERMS_HPP_
+#define SRC_STRATEGY_TERMS_HPP_
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "arithmetic/bits.hpp"
+#include "arithmetic/checked.hpp"
+#include "arithmetic/integer.hpp"
+#include "protocol/matrix.hpp"
+#include "protocol/protocol.hpp"
+#include "raise.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+/*
+ * Building blocks of strategies whose output is a ratio of polynomials
+ * of first degree in each input, such as Homography and Bihomography.
+ * A strategy hands its numerator and denominator terms as arrays of
+ * pointers, numerator and denominator terms paired by position.
+ * Operations that can overflow answer false and may leave terms half
+ * updated, so strategies work on a copy of their coefficients.
+ */
+
+/**
+ * Region of n/d, without dividing nor overflowing.
+ * \return Message whose region holds n/d; Protocol::End if n/d is zero
+ *         or undefined.
+ */
+template <typename T>
+protocol::Protocol Classify(const T& n, const T& d)
+{
+    // Sums and differences below only mix terms of opposite signs.
+    if (!d)
+    {
+        return n > 0 ? protocol::Protocol::Turn : n < 0 ? protocol::Protocol::Ground : protocol::Protocol::End;
+    }
+    if (!n)
+    {
+        return protocol::Protocol::End;
+    }
+    bool positive_d = d > 0;
+    if ((n > 0) == positive_d)
+    {
+        // n/d > 1
+        if (positive_d ? n > d : n < d)
+        {
+            return protocol::Protocol::Turn;
+        }
+        // 1/2 < n/d <= 1
+        if (positive_d ? n > d - n : n < d - n)
+        {
+            return protocol::Protocol::Uncover;
+        }
+        return protocol::Protocol::Amplify;
+    }
+    // -1 <= n/d < 0
+    T sum = n + d;
+    if (positive_d ? sum >= 0 : sum <= 0)
+    {
+        return protocol::Protocol::Reflect;
+    }
+    return protocol::Protocol::Ground;
+}
+
+/**
+ * Can a denominator of first degree in each input vanish in the input range?
+ * Such a denominator is a weighted mean of its values at the corners of the
+ * input range, so it has no root if these have all the same sign.
+ * \param[in] corners Denominator at the corners of the input range.
+ */
+template <typename T, std::size_t N>
+bool HasRootInRange(const T* const (&corners)[N])
+{
+    bool positive = *corners[0] > 0;
+    for (const T* a : corners)
+    {
+        if (!*a || (*a > 0) != positive)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Transforms N/D into the value left after egesting a message.
+ * \param[in] output Egested message.
+ * \return false on overflow.
+ */
+template <typename T, std::size_t N>
+bool EgestTerms(protocol::Protocol output, T* const (&n)[N], T* const (&d)[N])
+{
+    switch (output)
+    {
+        case protocol::Protocol::Amplify:
+        {
+            // 2N/D = (2N)/D = N/(D/2)
+            bool even = true;
+            for (T* a : d)
+            {
+                even = even && *a % 2 == 0;
+            }
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (even)
+                {
+                    *d[i] /= 2;
+                }
+                else if (!arithmetic::Mul(*n[i], T(2), n[i]))
+                {
+                    return false;
+                }
+            }
+            break;
+        }
+        case protocol::Protocol::Uncover:
+            // 1/(N/D)-1 = (D-N)/N
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (!arithmetic::Sub(*d[i], *n[i], d[i]))
+                {
+                    return false;
+                }
+                std::swap(*n[i], *d[i]);
+            }
+            break;
+        case protocol::Protocol::Turn:
+            // 1/(N/D) = D/N
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                std::swap(*n[i], *d[i]);
+            }
+            break;
+        case protocol::Protocol::Reflect:
+            // -(N/D) = (-N)/D
+            for (T* a : n)
+            {
+                if (!arithmetic::Negate(a))
+                {
+                    return false;
+                }
+            }
+            break;
+        case protocol::Protocol::Ground:
+            // 1/(-(N/D)) = (-D)/N
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (!arithmetic::Negate(d[i]))
+                {
+                    return false;
+                }
+                std::swap(*n[i], *d[i]);
+            }
+            break;
+        default:
+            Raise<std::logic_error>("unhandled protocol message");
+    }
+    return true;
+}
+
+/**
+ * Substitutes an input \f$x_1=\frac{ax_2+b}{cx_2+d}\f$, by multiplying
+ * numerator and denominator by \f$cx_2+d\f$:
+ * \f$p_1x_1+p_0\f$ becomes \f$(p_1a+p_0c)x_2+(p_1b+p_0d)\f$.
+ * \param[in] m Substitution matrix.
+ * \param[in,out] first Terms of first order in the input.
+ * \param[in,out] second Their counterparts independent of the input.
+ * \return false on overflow.
+ */
+template <typename T, std::size_t N>
+bool SubstituteTerms(const protocol::Matrix& m, T* const (&first)[N], T* const (&second)[N])
+{
+    const T a(m.a), b(m.b), c(m.c), d(m.d);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        T p1, p0;
+        if (!arithmetic::Dot(*first[i], a, *second[i], c, &p1) || !arithmetic::Dot(*first[i], b, *second[i], d, &p0))
+        {
+            return false;
+        }
+        *first[i] = std::move(p1);
+        *second[i] = std::move(p0);
+    }
+    return true;
+}
+
+/**
+ * Divides terms by their greatest common power of two.
+ * \return Were terms divided?
+ */
+template <typename T, std::size_t N>
+bool TakeOutTwos(T* const (&terms)[N])
+{
+    unsigned int shift = 0;
+    if constexpr (std::is_same_v<T, arithmetic::Integer>)
+    {
+        bool first = true;
+        for (const T* a : terms)
+        {
+            if (*a && (first || a->TrailingZeros() < shift))
+            {
+                shift = a->TrailingZeros();
+                first = false;
+            }
+        }
+    }
+    else
+    {
+        decltype(arithmetic::Magnitude(T())) bits = 0;
+        for (const T* a : terms)
+        {
+            bits |= arithmetic::Magnitude(*a);
+        }
+        shift = bits ? arithmetic::CountTrailingZeros(bits) : 0;
+    }
+    if (!shift)
+    {
+        return false;
+    }
+    for (T* a : terms)
+    {
+        *a >>= shift;
+    }
+    return true;
+}
+
+/**
+ * Divides terms by their greatest common divisor.
+ * Integer terms only divide by their common power of two.
+ * \return Were terms divided?
+ */
+template <typename T, std::size_t N>
+bool ReduceTerms(T* const (&terms)[N])
+{
+    if constexpr (std::is_same_v<T, arithmetic::Integer>)
+    {
+        // Integer only divides by machine integers.
+        return TakeOutTwos(terms);
+    }
+    else
+    {
+        decltype(arithmetic::Magnitude(T())) divisor = 0;
+        for (const T* a : terms)
+        {
+            divisor = arithmetic::Gcd(divisor, arithmetic::Magnitude(*a));
+        }
+        if (divisor <= 1)
+        {
+            return false;
+        }
+        for (T* a : terms)
+        {
+            *a = arithmetic::Divide(*a, divisor);
+        }
+        return true;
+    }
+}
+
+/**
+ * Normal form of terms, for telling apart states of a strategy.
+ * Terms are divided by their greatest common divisor and signed so that
+ * the first term that is not zero is positive; so proportional terms,
+ * which egest and ingest alike, have the same normal form.
+ * \param[out] out Normalised terms.
+ * \return false if terms have no normal form in __int128, as Integer terms.
+ */
+template <typename T, std::size_t N>
+bool NormalizeTerms(T* const (&terms)[N], __int128 (&out)[N])
+{
+    if constexpr (std::is_same_v<std::remove_const_t<T>, arithmetic::Integer>)
+    {
+        return false;
+    }
+    else
+    {
+        using U = unsigned __int128;
+        U divisor = 0;
+        bool negative = false;
+        for (const T* a : terms)
+        {
+            if (!divisor && *a)
+            {
+                negative = *a < 0;
+            }
+            divisor = arithmetic::Gcd(divisor, U(arithmetic::Magnitude(*a)));
+        }
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            U quotient = divisor ? U(arithmetic::Magnitude(*terms[i])) / divisor : 0;
+            if (quotient >> 127)
+            {
+                return false;
+            }
+            out[i] = (*terms[i] < 0) != negative ? -__int128(quotient) : __int128(quotient);
+        }
+        return true;
+    }
+}
+
+/**
+ * \return Are N and D proportional, so that N/D is constant?
+ *         false if that cannot be told without overflow.
+ */
+template <typename T, std::size_t N>
+bool Proportional(T* const (&n)[N], T* const (&d)[N])
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = i + 1; j < N; ++j)
+        {
+            T a, b;
+            if (!arithmetic::Mul(*n[i], *d[j], &a) || !arithmetic::Mul(*n[j], *d[i], &b) || a != b)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_STRATEGY_TERMS_HPP_
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "transposition_table.hpp"
+
+#include "tracelog.h"
+
+using deepnum::clarith::protocol::Protocol;
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+namespace
+{
+
+thread_local TranspositionTable* current = nullptr;
+
+// Tag of empty slots; tags of transitions are narrower.
+constexpr std::uint32_t kEmpty = ~std::uint32_t(0);
+
+bool operator==(const TranspositionTable::Key& k, const TranspositionTable::Key& l)
+{
+    return k.tag == l.tag && std::equal(std::begin(k.state), std::end(k.state), std::begin(l.state));
+}
+
+}  // namespace
+
+TranspositionTable::TranspositionTable(std::size_t capacity)
+{
+    std::size_t size = 1;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    Entry empty {};
+    empty.key.tag = kEmpty;
+    entries_.assign(size, empty);
+    tracelog(size);
+}
+
+TranspositionTable* TranspositionTable::Install(TranspositionTable* table)
+{
+    return std::exchange(current, table);
+}
+
+TranspositionTable* TranspositionTable::Current()
+{
+    return current;
+}
+
+const TranspositionTable::Entry* TranspositionTable::Find(const Key& key)
+{
+    const Entry& entry = entries_[Slot(key)];
+    if (!(entry.key == key))
+    {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    return &entry;
+}
+
+void TranspositionTable::Store(const Key& key, const int (&state)[4], bool pole_in_range,
+                               const Protocol* output, std::size_t size)
+{
+    Entry& entry = entries_[Slot(key)];
+    entry.key = key;
+    std::copy(std::begin(state), std::end(state), entry.state);
+    entry.pole_in_range = pole_in_range;
+    entry.size = static_cast<std::uint8_t>(size);
+    std::transform(output, output + size, entry.output, [](Protocol m) { return static_cast<std::uint8_t>(m); });
+}
+
+std::size_t TranspositionTable::Capacity() const
+{
+    return entries_.size();
+}
+
+std::uint64_t TranspositionTable::Hits() const
+{
+    return hits_;
+}
+
+std::uint64_t TranspositionTable::Misses() const
+{
+    return misses_;
+}
+
+std::size_t TranspositionTable::Slot(const Key& key) const
+{
+    std::uint64_t h = key.tag;
+    for (int a : key.state)
+    {
+        h = (h ^ static_cast<std::uint32_t>(a)) * 0x9e3779b97f4a7c15u;
+    }
+    return static_cast<std::size_t>(h ^ h >> 32) & (entries_.size() - 1);
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_STRATEGY_TRANSPOSITION_TABLE_HPP_
+#define SRC_STRATEGY_TRANSPOSITION_TABLE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "protocol/protocol.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+/**
+ * Bounded cache of Homography transitions.
+ * A transition takes a Homography from a state, through the ingest of a
+ * run of input messages, to the state where it needs input again,
+ * along with the messages it egests on the way. Homographies with the
+ * same coefficients reading equivalent inputs go through the same
+ * transitions; with a table installed, they look them up instead of
+ * working them out message by message.
+ *
+ * The table is direct mapped: each transition has a single slot, and
+ * storing a transition evicts whatever was in its slot.
+ * Tables are installed per thread, and only serve homographies created
+ * after their installation.
+ * \see Homography
+ */
+class TranspositionTable
+{
+ public:
+
+    /**
+     * Maximum number of messages egested by a cached transition.
+     */
+    static constexpr std::size_t kMaxOutput = 24;
+
+    /**
+     * Start of a transition: coefficients of a Homography, and a tag
+     * telling the input run and whatever else the transition depends on.
+     */
+    struct Key
+    {
+        int state[4];
+        std::uint32_t tag;
+    };
+
+    /**
+     * Cached transition.
+     */
+    struct Entry
+    {
+        Key key;
+
+        /**
+         * Coefficients at the end of the transition.
+         */
+        int state[4];
+
+        /**
+         * Whether a pole lies in the input range at the end of the transition.
+         */
+        bool pole_in_range;
+
+        /**
+         * Number of egested messages.
+         */
+        std::uint8_t size;
+
+        /**
+         * Egested messages.
+         */
+        std::uint8_t output[kMaxOutput];
+    };
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+    TranspositionTable(TranspositionTable&&) = delete;
+    TranspositionTable& operator=(TranspositionTable&&) = delete;
+
+    /**
+     * \param[in] capacity Number of transitions, rounded up to a power of two.
+     */
+    explicit TranspositionTable(std::size_t capacity);
+
+    /**
+     * Installs a table for the calling thread.
+     * \param[in] table Table; null to uninstall.
+     * \pre table outlives the homographies created while it is installed.
+     * \return Table installed before.
+     */
+    static TranspositionTable* Install(TranspositionTable* table);
+
+    /**
+     * \return Table of the calling thread; null if none is installed.
+     */
+    static TranspositionTable* Current();
+
+    /**
+     * Looks up a transition.
+     * \return Cached transition; null if missing.
+     */
+    const Entry* Find(const Key& key);
+
+    /**
+     * Caches a transition, evicting the one in its slot.
+     * \param[in] key Start of transition.
+     * \param[in] state Coefficients at the end of transition.
+     * \param[in] pole_in_range Is a pole in the input range at the end of transition?
+     * \param[in] output Egested messages.
+     * \param[in] size Number of egested messages.
+     * \pre size is not greater than kMaxOutput.
+     */
+    void Store(const Key& key, const int (&state)[4], bool pole_in_range,
+               const protocol::Protocol* output, std::size_t size);
+
+    /**
+     * \return Number of transitions.
+     */
+    std::size_t Capacity() const;
+
+    /**
+     * \return Number of lookups that found their transition.
+     */
+    std::uint64_t Hits() const;
+
+    /**
+     * \return Number of lookups that missed their transition.
+     */
+    std::uint64_t Misses() const;
+
+ private:
+
+    std::size_t Slot(const Key& key) const;
+
+    std::vector<Entry> entries_;
+    std::uint64_t hits_ { 0 };
+    std::uint64_t misses_ { 0 };
+};
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_STRATEGY_TRANSPOSITION_TABLE_HPP_
@@ -19,6 +19,7 @@
  */
 
 #include "protocol/protocol.hpp"
+#include "raise.hpp"
 #include "unavailable_error.hpp"
 
 #include "zero.hpp"
@@ -44,15 +45,26 @@ Zero::~Zero()
     tracelog("");
 }
 
-Protocol Zero::Egest()
+bool Zero::Egest(Protocol* message)
 {
     tracelog("egesting " << Protocol::End);
-    return Protocol::End;
+    *message = Protocol::End;
+    return true;
 }
 
-gsl::owner<Strategy*> Zero::GetNewStrategy() const
+std::size_t Zero::EgestMany(Protocol* out, std::size_t max)
 {
-    throw UnavailableError{};
+    if (!max)
+    {
+        return 0;
+    }
+    // Nothing follows Protocol::End.
+    return Zero::Egest(out);
+}
+
+gsl::owner<Strategy*> Zero::GetNewStrategy(std::pmr::memory_resource* /* resource */) const
+{
+    Raise<UnavailableError>();
 }
 
 }  // namespace strategy
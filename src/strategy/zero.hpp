@@ -47,13 +47,14 @@ class Zero : public Strategy
 
     Zero(const Zero&) = delete;
     Zero& operator=(const Zero&) = delete;
-    Zero(Zero&&) = delete;
+    Zero(Zero&&) = default;
     Zero& operator=(Zero&&) = delete;
 
     Zero();
     virtual ~Zero();
-    protocol::Protocol Egest() override;
-    gsl::owner<Strategy*> GetNewStrategy() const override;
+    bool Egest(protocol::Protocol* message) override;
+    std::size_t EgestMany(protocol::Protocol* out, std::size_t max) override;
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override;
 };
 
 }  // namespace strategy
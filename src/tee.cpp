@@ -0,0 +1,167 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "number.hpp"
+#include "raise.hpp"
+#include "strategy/strategy.hpp"
+#include "strategy/unavailable_error.hpp"
+#include "strategy/zero.hpp"
+
+#include "tee.hpp"
+
+#include "tracelog.h"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Strategy;
+
+namespace deepnum
+{
+namespace clarith
+{
+
+/**
+ * Reads the messages of a Tee from the shared buffer.
+ */
+class Tee::Reader : public Strategy
+{
+ public:
+
+    Reader(Tee* tee, std::size_t id)
+            : tee_(tee), id_(id)
+    {
+        tracelog(tee << " " << id);
+    }
+
+    ~Reader()
+    {
+        tracelog("");
+        tee_->Release(id_);
+    }
+
+    bool Egest(Protocol* message) override
+    {
+        std::size_t& position = tee_->positions_[id_];
+        if (!tee_->Fill(position + 1))
+        {
+            return false;
+        }
+        *message = tee_->buffer_[position++ - tee_->base_];
+        return true;
+    }
+
+    std::size_t EgestMany(Protocol* out, std::size_t max) override
+    {
+        std::size_t& position = tee_->positions_[id_];
+        tee_->Fill(position + max);
+        auto first = tee_->buffer_.begin() + (position - tee_->base_);
+        std::size_t count = std::min<std::size_t>(max, tee_->buffer_.end() - first);
+        std::copy(first, first + count, out);
+        position += count;
+        return count;
+    }
+
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override
+    {
+        if (tee_->x_ || tee_->positions_[id_] != tee_->base_ + tee_->buffer_.size())
+        {
+            Raise<strategy::UnavailableError>();
+        }
+        return new (resource) strategy::Zero();
+    }
+
+ private:
+
+    Tee* tee_;
+    std::size_t id_;
+};
+
+const Tee* Tee::Split(Number* x, std::size_t count, Number** readers)
+{
+    std::pmr::memory_resource* resource = GetResource(x);
+    Tee* tee = new (resource) Tee(x, count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        readers[i] = new (resource) Number(new (resource) Reader(tee, i));
+    }
+    return tee;
+}
+
+Tee::Tee(Number* x, std::size_t count)
+        : x_(x),
+        positions_(count, 0),
+        live_(count)
+{
+    tracelog(x << " " << count);
+}
+
+Tee::~Tee()
+{
+    tracelog("");
+    delete x_;
+}
+
+std::size_t Tee::Buffered() const
+{
+    return buffer_.size();
+}
+
+bool Tee::Fill(std::size_t size)
+{
+    Protocol block[64];
+    while (x_ && base_ + buffer_.size() < size)
+    {
+        // Make room before driving the source.
+        Trim();
+        std::size_t count = x_->EgestMany(block, std::min(size - base_ - buffer_.size(), std::size(block)));
+        tracelog("buffering " << count << " messages from " << x_);
+        buffer_.insert(buffer_.end(), block, block + count);
+        if (block[count - 1] == Protocol::End)
+        {
+            tracelog(x_ << " completely read");
+            delete x_;
+            x_ = nullptr;
+        }
+    }
+    return base_ + buffer_.size() >= size;
+}
+
+void Tee::Trim()
+{
+    std::size_t position = *std::min_element(positions_.begin(), positions_.end());
+    std::size_t passed = std::min(position, base_ + buffer_.size()) - base_;
+    buffer_.erase(buffer_.begin(), buffer_.begin() + passed);
+    base_ += passed;
+}
+
+void Tee::Release(std::size_t reader)
+{
+    positions_[reader] = std::numeric_limits<std::size_t>::max();
+    if (!--live_)
+    {
+        delete this;
+    }
+}
+
+}  // namespace clarith
+}  // namespace deepnum
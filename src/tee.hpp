@@ -0,0 +1,105 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef SRC_TEE_HPP_
+#define SRC_TEE_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "allocatable.hpp"
+#include "protocol/protocol.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+
+class Number;
+
+/**
+ * Fan-out of a number to several readers.
+ * Strategies own their inputs, so an expression that takes a value more
+ * than once, such as \f$\frac{x+1}{x-1}\f$ computed as the quotient of
+ * two homographies of \f$x\f$, would build and compute \f$x\f$ once per
+ * use. A tee computes it once and feeds it to several readers, which are
+ * numbers of their own.
+ *
+ * Messages are kept in a buffer shared by the readers. The source is only
+ * driven as far as the foremost reader needs, and messages that every
+ * reader has passed are dropped from the buffer; so readers that move
+ * together keep the buffer small.
+ *
+ * A tee lives as long as any of its readers. Both are allocated from the
+ * memory resource of the source.
+ * \see Memo
+ */
+class Tee : public Allocatable
+{
+ public:
+
+    Tee(const Tee&) = delete;
+    Tee& operator=(const Tee&) = delete;
+    Tee(Tee&&) = delete;
+    Tee& operator=(Tee&&) = delete;
+
+    /**
+     * Splits a number into several numbers of the same value.
+     * \param[in] x Source.
+     * \param[in] count Number of readers.
+     * \param[out] readers count new numbers, each reading x from its start.
+     * \pre x not null and dynamically allocated, count is not zero.
+     * \return The tee, for inspection while any reader lives.
+     */
+    static const Tee* Split(gsl::owner<Number*> x, std::size_t count, gsl::owner<Number*>* readers);
+
+    /**
+     * \return Number of messages held for readers behind the foremost one.
+     */
+    std::size_t Buffered() const;
+
+ private:
+
+    class Reader;
+
+    Tee(gsl::owner<Number*> x, std::size_t count);
+    ~Tee();
+
+    bool Fill(std::size_t size);
+    void Trim();
+    void Release(std::size_t reader);
+
+    // Null once completely read.
+    Number* x_;
+    std::deque<protocol::Protocol> buffer_;
+    // Position in the sequence of the first buffered message.
+    std::size_t base_ { 0 };
+    // Position of each reader in the sequence; past the end when deleted.
+    std::vector<std::size_t> positions_;
+    std::size_t live_;
+};
+
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // SRC_TEE_HPP_
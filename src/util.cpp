@@ -84,5 +84,24 @@ RETURN_ZERO:
 
 }
 
+protocol::Buffer Util::ToBuffer(Number* n)
+{
+    traceloc("materializing " << n);
+    protocol::Buffer buffer;
+    Protocol messages[64];
+    std::size_t count;
+    do
+    {
+        count = n->EgestMany(messages, 64);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            buffer.Append(messages[i]);
+        }
+    } while (messages[count - 1] != Protocol::End);
+    delete n;
+    traceloc(buffer.Size() << " messages from " << n);
+    return buffer;
+}
+
 }  // namespace clarith
 }  // namespace deepnum
@@ -23,6 +23,8 @@
 
 #include <gsl/gsl>
 
+#include "protocol/buffer.hpp"
+
 namespace deepnum
 {
 namespace clarith
@@ -50,6 +52,18 @@ class Util
      */
     static int Compare(gsl::owner<Number*> n1, gsl::owner<Number*> n2);
 
+    /**
+     * Materialize a number.
+     * Reduces a number to its whole Protocol sequence.
+     * The sequence can be turned back into a number
+     * with strategy::Playback.
+     *
+     * \param[in] n Number.
+     * \pre n not null.
+     * \return Protocol sequence of n, ending with protocol::Protocol::End.
+     */
+    static protocol::Buffer ToBuffer(gsl::owner<Number*> n);
+
  private:
     Util();
 };
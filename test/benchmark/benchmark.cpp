@@ -0,0 +1,119 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "benchmark.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+
+namespace
+{
+
+// Minimum duration of a timed run.
+constexpr std::chrono::milliseconds kMinRunTime { 250 };
+
+}  // namespace
+
+Benchmark::Benchmark(const char* group, const char* name, Body body)
+        : name_(std::string(group) + "." + name),
+          body_(body),
+          iterations_(1),
+          items_(0)
+{
+    Registry().push_back(this);
+}
+
+long Benchmark::Iterations() const
+{
+    return iterations_;
+}
+
+void Benchmark::SetItems(double items)
+{
+    items_ = items;
+}
+
+void Benchmark::Report(const char* name, double value)
+{
+    figures_.emplace_back(name, value);
+}
+
+std::vector<Benchmark*>& Benchmark::Registry()
+{
+    static std::vector<Benchmark*> registry;
+    return registry;
+}
+
+void Benchmark::Run()
+{
+    std::chrono::duration<double, std::nano> elapsed;
+    iterations_ = 1;
+    while (true)
+    {
+        figures_.clear();
+        items_ = 0;
+        auto start = std::chrono::steady_clock::now();
+        body_(this);
+        elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed >= kMinRunTime)
+        {
+            break;
+        }
+        iterations_ *= elapsed * 10 < kMinRunTime ? 10 : 2;
+    }
+    std::printf("%-48s %12.1f ns %12ld iterations", name_.c_str(),
+                elapsed.count() / iterations_, iterations_);
+    if (items_)
+    {
+        std::printf("  %.2f ns/item", elapsed.count() / items_);
+    }
+    for (const auto& figure : figures_)
+    {
+        std::printf("  %s %g", figure.first.c_str(), figure.second);
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+int Benchmark::RunAll(int argc, char** argv)
+{
+    for (Benchmark* benchmark : Registry())
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+        {
+            selected = selected || std::strstr(benchmark->name_.c_str(), argv[i]);
+        }
+        if (selected)
+        {
+            benchmark->Run();
+        }
+    }
+    return 0;
+}
+
+}  // namespace clarith
+}  // namespace deepnum
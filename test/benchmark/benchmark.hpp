@@ -0,0 +1,119 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef TEST_BENCHMARK_BENCHMARK_HPP_
+#define TEST_BENCHMARK_BENCHMARK_HPP_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace deepnum
+{
+namespace clarith
+{
+
+/**
+ * Micro benchmark.
+ * Benchmarks are defined with the BENCHMARK macro. Their body must repeat
+ * the measured operation Iterations() times; the iteration count is raised
+ * until the whole run lasts long enough to be timed reliably.
+ */
+class Benchmark
+{
+ public:
+
+    using Body = void (*)(Benchmark* benchmark);
+
+    Benchmark(const Benchmark&) = delete;
+    Benchmark& operator=(const Benchmark&) = delete;
+    Benchmark(Benchmark&&) = delete;
+    Benchmark& operator=(Benchmark&&) = delete;
+
+    /**
+     * Register a benchmark.
+     * \param[in] group Benchmark group name.
+     * \param[in] name Benchmark name.
+     * \param[in] body Measured code.
+     */
+    Benchmark(const char* group, const char* name, Body body);
+
+    /**
+     * \return How many times the measured operation must be repeated.
+     */
+    long Iterations() const;
+
+    /**
+     * Report a figure along with the measured time.
+     * \param[in] name Figure name.
+     * \param[in] value Figure value.
+     */
+    void Report(const char* name, double value);
+
+    /**
+     * Report how many items (eg: messages) were processed in a run,
+     * so that the time per item is shown.
+     * \param[in] items Number of processed items.
+     */
+    void SetItems(double items);
+
+    /**
+     * Keep the compiler from optimizing away a computed value.
+     * \param[in] value Computed value.
+     */
+    template <typename T>
+    static void Keep(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /**
+     * Run registered benchmarks.
+     * \param[in] argc Argument count.
+     * \param[in] argv Arguments; when given, only benchmarks whose
+     *                 "group.name" contains any of them are run.
+     * \return Process exit status.
+     */
+    static int RunAll(int argc, char** argv);
+
+ private:
+    void Run();
+    static std::vector<Benchmark*>& Registry();
+
+    std::string name_;
+    Body body_;
+    long iterations_;
+    double items_;
+    std::vector<std::pair<std::string, double>> figures_;
+};
+
+}  // namespace clarith
+}  // namespace deepnum
+
+/**
+ * Define and register a benchmark.
+ * The body receives a Benchmark* named benchmark.
+ */
+#define BENCHMARK(group, name) \
+    static void group##_##name##_body(deepnum::clarith::Benchmark* benchmark); \
+    static deepnum::clarith::Benchmark group##_##name##_instance(#group, #name, group##_##name##_body); \
+    static void group##_##name##_body(deepnum::clarith::Benchmark* benchmark)
+
+#endif  // TEST_BENCHMARK_BENCHMARK_HPP_
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <config.h>
+
+#include <cstdio>
+
+#include "benchmark.hpp"
+
+int main(int argc, char** argv)
+{
+#if TRACE || NUMBER_SANITY_CHECK
+    std::fprintf(stderr, "warning: library instrumentation is enabled; "
+                 "configure with --disable-trace --disable-number-sanity-check "
+                 "for meaningful figures.\n");
+#endif
+    return deepnum::clarith::Benchmark::RunAll(argc, argv);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <config.h>
+
+#include <cstddef>
+#include <utility>
+
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "statistics.hpp"
+#include "strategy/bihomography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "util.hpp"
+
+#include "benchmark.hpp"
+
+using deepnum::clarith::Benchmark;
+using deepnum::clarith::Number;
+using deepnum::clarith::Statistics;
+using deepnum::clarith::Util;
+using deepnum::clarith::protocol::Buffer;
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Bihomography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+
+namespace
+{
+
+// Operands with long decompositions.
+constexpr int kInputs[][2] = {
+    { 355, 113 },
+    { 1000003, 999983 },
+    { -17, 12 },
+    { 65535, 65536 },
+};
+constexpr int kCount = sizeof(kInputs) / sizeof(kInputs[0]);
+
+// Operands replayed message by message.
+gsl::owner<Number*> NewInput(long i)
+{
+    static const Buffer sequences[kCount] = {
+        Util::ToBuffer(new Number(std::in_place_type<Ratio>, kInputs[0][0], kInputs[0][1])),
+        Util::ToBuffer(new Number(std::in_place_type<Ratio>, kInputs[1][0], kInputs[1][1])),
+        Util::ToBuffer(new Number(std::in_place_type<Ratio>, kInputs[2][0], kInputs[2][1])),
+        Util::ToBuffer(new Number(std::in_place_type<Ratio>, kInputs[3][0], kInputs[3][1])),
+    };
+    return new Number(std::in_place_type<Playback>, &sequences[i % kCount]);
+}
+
+// Drain operations built by make over pairs of operands, reporting time and range tests per message.
+template <typename Make>
+void Drain(Benchmark* benchmark, Make make)
+{
+    Statistics::Reset();
+    std::size_t messages = 0;
+    Protocol out[64];
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Number* number = new Number(make(NewInput(i), NewInput(i / kCount + 1)));
+        std::size_t count;
+        do
+        {
+            count = number->EgestMany(out, 64);
+            messages += count;
+        } while (out[count - 1] != Protocol::End);
+        delete number;
+    }
+    benchmark->SetItems(messages);
+#if STATISTICS
+    benchmark->Report("range tests/message", double(Statistics::Current().range_tests) / messages);
+    benchmark->Report("promotions/number", double(Statistics::Current().promotions) / benchmark->Iterations());
+    benchmark->Report("reductions/number", double(Statistics::Current().reductions) / benchmark->Iterations());
+#endif
+}
+
+}  // namespace
+
+BENCHMARK(BihomographyEgest, Sum)
+{
+    Drain(benchmark, Bihomography::Sum);
+}
+
+BENCHMARK(BihomographyEgest, Difference)
+{
+    Drain(benchmark, Bihomography::Difference);
+}
+
+BENCHMARK(BihomographyEgest, Product)
+{
+    Drain(benchmark, Bihomography::Product);
+}
+
+BENCHMARK(BihomographyEgest, Quotient)
+{
+    Drain(benchmark, Bihomography::Quotient);
+}
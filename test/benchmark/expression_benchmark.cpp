@@ -0,0 +1,99 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <utility>
+
+#include "expression.hpp"
+#include "number.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/bihomography.hpp"
+#include "strategy/ratio.hpp"
+
+#include "benchmark.hpp"
+
+using deepnum::clarith::Benchmark;
+using deepnum::clarith::Expression;
+using deepnum::clarith::Graph;
+using deepnum::clarith::Number;
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Bihomography;
+using deepnum::clarith::strategy::Ratio;
+
+namespace
+{
+
+/*
+ * Newton iterations towards the square root of two, from one:
+ * each one takes the previous one twice, as (x^2+2)/(2x).
+ */
+constexpr int kIterations = 5;
+
+gsl::owner<Number*> NewTree(int iterations)
+{
+    if (!iterations)
+    {
+        return new Number(std::in_place_type<Ratio>, 1, 1);
+    }
+    return new Number(new Bihomography(NewTree(iterations - 1), NewTree(iterations - 1), 1, 0, 0, 2, 0, 1, 1, 0));
+}
+
+// Read a number to its end.
+std::size_t Drain(gsl::owner<Number*> number)
+{
+    std::size_t messages = 0;
+    Protocol out[64];
+    std::size_t count;
+    do
+    {
+        count = number->EgestMany(out, 64);
+        messages += count;
+    } while (out[count - 1] != Protocol::End);
+    delete number;
+    return messages;
+}
+
+}  // namespace
+
+BENCHMARK(ExpressionSharing, Tree)
+{
+    std::size_t messages = 0;
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        messages += Drain(NewTree(kIterations));
+    }
+    benchmark->SetItems(messages);
+}
+
+BENCHMARK(ExpressionSharing, Graph)
+{
+    std::size_t messages = 0;
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Graph graph;
+        Expression x = graph.Ratio(1, 1);
+        for (int j = 0; j < kIterations; ++j)
+        {
+            x = graph.Bihomography(x, x, 1, 0, 0, 2, 0, 1, 1, 0);
+        }
+        messages += Drain(x.Evaluate());
+    }
+    benchmark->SetItems(messages);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <iterator>
+#include <utility>
+
+#include "memo.hpp"
+#include "number.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "util.hpp"
+
+#include "benchmark.hpp"
+
+using deepnum::clarith::Benchmark;
+using deepnum::clarith::Memo;
+using deepnum::clarith::Number;
+using deepnum::clarith::Util;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+
+namespace
+{
+
+// Values one number is compared against.
+constexpr int kBounds[][2] = {
+    { 1, 1 },
+    { 3, 2 },
+    { 4, 3 },
+    { 5, 4 },
+    { 13, 10 },
+    { 133, 100 },
+    { 1333, 1000 },
+    { 13333, 10000 },
+};
+
+// A chain of homographies over a streamed input.
+gsl::owner<Number*> NewValue()
+{
+    Number* x = new Number(std::in_place_type<Playback>, Util::ToBuffer(new Number(new Ratio(355, 113))));
+    x = new Number(std::in_place_type<Homography>, x, 2, 1, 1, 3);
+    x = new Number(std::in_place_type<Homography>, x, 1, 3, 2, 1);
+    return new Number(std::in_place_type<Homography>, x, 3, 1, 1, 1);
+}
+
+}  // namespace
+
+BENCHMARK(CompareMany, Rebuilt)
+{
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        for (const auto& bound : kBounds)
+        {
+            Util::Compare(NewValue(), new Number(new Ratio(bound[0], bound[1])));
+        }
+    }
+    benchmark->SetItems(benchmark->Iterations() * std::size(kBounds));
+}
+
+BENCHMARK(CompareMany, Memoized)
+{
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Memo memo(NewValue());
+        for (const auto& bound : kBounds)
+        {
+            Util::Compare(memo.NewCursor(), new Number(new Ratio(bound[0], bound[1])));
+        }
+    }
+    benchmark->SetItems(benchmark->Iterations() * std::size(kBounds));
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+#include "number.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/bihomography.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/ratio.hpp"
+#include "util.hpp"
+
+#include "benchmark.hpp"
+
+using deepnum::clarith::Benchmark;
+using deepnum::clarith::Number;
+using deepnum::clarith::Util;
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Bihomography;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Ratio;
+
+namespace
+{
+
+/*
+ * Pairs of close ratios, whose comparison goes through a long common
+ * sequence of protocol messages.
+ */
+constexpr int kRatios[][4] = {
+    { 1, 3, 2, 5 },
+    { 355, 113, 22, 7 },
+    { -1001, 1000, -1000, 999 },
+    { 65535, 65536, 65534, 65535 },
+    { 4181, 6765, 2584, 4181 },
+    { 1000003, 7, 1000001, 7 },
+    { -17, 12, -99, 70 },
+    { 12345, 54321, 12346, 54321 },
+};
+constexpr int kPairs = sizeof(kRatios) / sizeof(kRatios[0]);
+
+// Default memory resource that counts allocations.
+class CountingResource : public std::pmr::memory_resource
+{
+ public:
+
+    CountingResource()
+            : allocations_(0),
+            previous_(std::pmr::set_default_resource(this))
+    {
+    }
+
+    ~CountingResource()
+    {
+        std::pmr::set_default_resource(previous_);
+    }
+
+    long Allocations() const
+    {
+        return allocations_;
+    }
+
+ private:
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations_;
+        return previous_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        previous_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    long allocations_;
+    std::pmr::memory_resource* previous_;
+};
+
+}  // namespace
+
+BENCHMARK(NumberDispatch, VirtualRatioCompare)
+{
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        const int* r = kRatios[i % kPairs];
+        Benchmark::Keep(Util::Compare(new Number(new Ratio(r[0], r[1])),
+                                      new Number(new Ratio(r[2], r[3]))));
+    }
+}
+
+BENCHMARK(NumberDispatch, InPlaceRatioCompare)
+{
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        const int* r = kRatios[i % kPairs];
+        Benchmark::Keep(Util::Compare(new Number(std::in_place_type<Ratio>, r[0], r[1]),
+                                      new Number(std::in_place_type<Ratio>, r[2], r[3])));
+    }
+}
+
+BENCHMARK(NumberDispatch, VirtualHomographyEgest)
+{
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        const int* r = kRatios[i % kPairs];
+        Number number(new Homography(new Number(std::in_place_type<Ratio>, r[0], r[1]),
+                                     r[2], r[3], 1, 1));
+        while (number.Egest() != Protocol::End) {}
+    }
+}
+
+BENCHMARK(NumberDispatch, InPlaceHomographyEgest)
+{
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        const int* r = kRatios[i % kPairs];
+        Number number(std::in_place_type<Homography>,
+                      new Number(std::in_place_type<Ratio>, r[0], r[1]), r[2], r[3], 1, 1);
+        while (number.Egest() != Protocol::End) {}
+    }
+}
+
+BENCHMARK(NumberEgest, OneByOne)
+{
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Number number(std::in_place_type<Ratio>, 1000003, 999983);
+        while (number.Egest() != Protocol::End) {}
+    }
+}
+
+BENCHMARK(NumberEgest, Many)
+{
+    Protocol messages[64];
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Number number(std::in_place_type<Ratio>, 1000003, 999983);
+        while (messages[number.EgestMany(messages, 64) - 1] != Protocol::End) {}
+    }
+}
+
+/*
+ * Numbers whose strategies are held by pointer, read to the end.
+ * Their successors (a ratio, then zero) are built in place.
+ */
+BENCHMARK(NumberSuccession, PointerHeldRatio)
+{
+    CountingResource resource;
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        const int* r = kRatios[i % kPairs];
+        Number* number = new Number(new Ratio(r[0], r[1]));
+        while (number->Egest() != Protocol::End) {}
+        delete number;
+    }
+    benchmark->Report("allocations/number", double(resource.Allocations()) / benchmark->Iterations());
+}
+
+BENCHMARK(NumberSuccession, PointerHeldHomography)
+{
+    CountingResource resource;
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        const int* r = kRatios[i % kPairs];
+        Number* number = new Number(new Homography(new Number(new Ratio(r[0], r[1])), 1, 1, 0, 1));
+        while (number->Egest() != Protocol::End) {}
+        delete number;
+    }
+    benchmark->Report("allocations/number", double(resource.Allocations()) / benchmark->Iterations());
+}
+
+BENCHMARK(NumberSuccession, PointerHeldSum)
+{
+    CountingResource resource;
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        const int* r = kRatios[i % kPairs];
+        Number* number = new Number(Bihomography::Sum(new Number(new Ratio(r[0], r[1])),
+                                                      new Number(new Ratio(r[2], r[3]))));
+        while (number->Egest() != Protocol::End) {}
+        delete number;
+    }
+    benchmark->Report("allocations/number", double(resource.Allocations()) / benchmark->Iterations());
+}
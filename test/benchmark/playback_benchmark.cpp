@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <forward_list>
+#include <utility>
+
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "util.hpp"
+
+#include "benchmark.hpp"
+
+using deepnum::clarith::Benchmark;
+using deepnum::clarith::Number;
+using deepnum::clarith::Util;
+using deepnum::clarith::protocol::Buffer;
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+
+namespace
+{
+
+const Buffer& Sequence()
+{
+    static const Buffer sequence = Util::ToBuffer(new Number(new Ratio(-1000003, 999983)));
+    return sequence;
+}
+
+}  // namespace
+
+BENCHMARK(PlaybackReplay, ForwardList)
+{
+    const Buffer& sequence = Sequence();
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Number number(new Playback(new std::forward_list<Protocol>(sequence.begin(), sequence.end())));
+        while (number.Egest() != Protocol::End) {}
+    }
+    benchmark->Report("messages", sequence.Size());
+}
+
+BENCHMARK(PlaybackReplay, SharedBuffer)
+{
+    const Buffer& sequence = Sequence();
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Number number(std::in_place_type<Playback>, &sequence);
+        while (number.Egest() != Protocol::End) {}
+    }
+    benchmark->Report("messages", sequence.Size());
+}
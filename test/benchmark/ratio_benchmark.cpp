@@ -0,0 +1,113 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "protocol/protocol.hpp"
+#include "strategy/ratio.hpp"
+
+#include "benchmark.hpp"
+
+using deepnum::clarith::Benchmark;
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Ratio;
+using deepnum::clarith::strategy::Ratio128;
+using deepnum::clarith::strategy::Ratio64;
+
+namespace
+{
+
+// Ratios with 30+ bit denominators.
+constexpr unsigned int kRatios[][2] = {
+    { 3u, 1000000007u },
+    { 5u, 3u << 28 },
+    { 1u, 0xFFFFFFFFu },
+    { 123456789u, 0x80000000u },
+};
+constexpr int kCount = sizeof(kRatios) / sizeof(kRatios[0]);
+
+/*
+ * Decompose ratios at every integer width;
+ * wider ratios get their terms scaled to use their extra bits.
+ */
+template <typename R, typename U>
+void Decompose(Benchmark* benchmark, int shift)
+{
+    std::size_t messages = 0;
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        R ratio((U(kRatios[i % kCount][0]) << shift) + 1, U(kRatios[i % kCount][1]) << shift, true);
+        Protocol message;
+        while (ratio.Egest(&message))
+        {
+            ++messages;
+        }
+    }
+    benchmark->SetItems(messages);
+}
+
+}  // namespace
+
+BENCHMARK(RatioWidth, Int)
+{
+    Decompose<Ratio, unsigned int>(benchmark, 0);
+}
+
+BENCHMARK(RatioWidth, Int64)
+{
+    Decompose<Ratio64, std::uint64_t>(benchmark, 32);
+}
+
+BENCHMARK(RatioWidth, Int128)
+{
+    Decompose<Ratio128, unsigned __int128>(benchmark, 96);
+}
+
+BENCHMARK(RatioDecomposition, OneByOne)
+{
+    std::size_t messages = 0;
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Ratio ratio(kRatios[i % kCount][0], kRatios[i % kCount][1], true);
+        Protocol message;
+        while (ratio.Egest(&message))
+        {
+            ++messages;
+        }
+    }
+    benchmark->SetItems(messages);
+}
+
+BENCHMARK(RatioDecomposition, Many)
+{
+    std::size_t messages = 0;
+    Protocol buffer[128];
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Ratio ratio(kRatios[i % kCount][0], kRatios[i % kCount][1], true);
+        std::size_t count;
+        while ((count = ratio.EgestMany(buffer, 128)))
+        {
+            messages += count;
+        }
+    }
+    benchmark->SetItems(messages);
+}
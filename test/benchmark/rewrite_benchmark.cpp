@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <utility>
+
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "strategy/rewrite.hpp"
+#include "util.hpp"
+
+#include "benchmark.hpp"
+
+using deepnum::clarith::Benchmark;
+using deepnum::clarith::Number;
+using deepnum::clarith::Util;
+using deepnum::clarith::protocol::Buffer;
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Negation;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+using deepnum::clarith::strategy::Reciprocation;
+using deepnum::clarith::strategy::Scaling;
+
+namespace
+{
+
+// Inputs with long decompositions.
+constexpr int kInputs[][2] = {
+    { 355, 113 },
+    { 1000003, 999983 },
+    { -17, 12 },
+    { 65535, 65536 },
+};
+constexpr int kCount = sizeof(kInputs) / sizeof(kInputs[0]);
+
+// Inputs replayed message by message.
+gsl::owner<Number*> NewInput(long i)
+{
+    static const Buffer sequences[kCount] = {
+        Util::ToBuffer(new Number(std::in_place_type<Ratio>, kInputs[0][0], kInputs[0][1])),
+        Util::ToBuffer(new Number(std::in_place_type<Ratio>, kInputs[1][0], kInputs[1][1])),
+        Util::ToBuffer(new Number(std::in_place_type<Ratio>, kInputs[2][0], kInputs[2][1])),
+        Util::ToBuffer(new Number(std::in_place_type<Ratio>, kInputs[3][0], kInputs[3][1])),
+    };
+    return new Number(std::in_place_type<Playback>, &sequences[i % kCount]);
+}
+
+// Drain numbers built by make, reporting time per message.
+template <typename Make>
+void Drain(Benchmark* benchmark, Make make)
+{
+    std::size_t messages = 0;
+    Protocol out[64];
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Number* number = make(i);
+        std::size_t count;
+        do
+        {
+            count = number->EgestMany(out, 64);
+            messages += count;
+        } while (out[count - 1] != Protocol::End);
+        delete number;
+    }
+    benchmark->SetItems(messages);
+}
+
+}  // namespace
+
+BENCHMARK(Negate, Homography)
+{
+    Drain(benchmark, [](long i) { return new Number(std::in_place_type<Homography>, NewInput(i), -1, 0, 0, 1); });
+}
+
+BENCHMARK(Negate, Rewrite)
+{
+    Drain(benchmark, [](long i) { return new Number(new Negation(NewInput(i))); });
+}
+
+BENCHMARK(Reciprocal, Homography)
+{
+    Drain(benchmark, [](long i) { return new Number(std::in_place_type<Homography>, NewInput(i), 0, 1, 1, 0); });
+}
+
+BENCHMARK(Reciprocal, Rewrite)
+{
+    Drain(benchmark, [](long i) { return new Number(new Reciprocation(NewInput(i))); });
+}
+
+BENCHMARK(Halve, Homography)
+{
+    Drain(benchmark, [](long i) { return new Number(std::in_place_type<Homography>, NewInput(i), 1, 0, 0, 2); });
+}
+
+BENCHMARK(Halve, Rewrite)
+{
+    Drain(benchmark, [](long i) { return new Number(new Scaling(NewInput(i), -1)); });
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <utility>
+
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/bihomography.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "tee.hpp"
+#include "util.hpp"
+
+#include "benchmark.hpp"
+
+using deepnum::clarith::Benchmark;
+using deepnum::clarith::Number;
+using deepnum::clarith::Tee;
+using deepnum::clarith::Util;
+using deepnum::clarith::protocol::Buffer;
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Bihomography;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+
+namespace
+{
+
+// A costly value: a long chain of homographies over a streamed input.
+gsl::owner<Number*> NewValue()
+{
+    static const Buffer sequence = Util::ToBuffer(new Number(new Ratio(1000003, 999983)));
+    Number* x = new Number(std::in_place_type<Playback>, &sequence);
+    for (int depth = 0; depth < 8; ++depth)
+    {
+        x = new Number(std::in_place_type<Homography>, x, 2, 1, 1, 3);
+        x = new Number(std::in_place_type<Homography>, x, 1, 3, 2, 1);
+    }
+    return x;
+}
+
+// Drain (x+1)/(x-1), reporting time per message.
+template <typename Make>
+void Drain(Benchmark* benchmark, Make make)
+{
+    std::size_t messages = 0;
+    Protocol out[64];
+    for (long i = 0; i < benchmark->Iterations(); ++i)
+    {
+        Number* x[2];
+        make(x);
+        Number number(Bihomography::Quotient(
+                new Number(std::in_place_type<Homography>, x[0], 1, 1, 0, 1),
+                new Number(std::in_place_type<Homography>, x[1], 1, -1, 0, 1)));
+        std::size_t count;
+        do
+        {
+            count = number.EgestMany(out, 64);
+            messages += count;
+        } while (out[count - 1] != Protocol::End);
+    }
+    benchmark->SetItems(messages);
+}
+
+}  // namespace
+
+BENCHMARK(TeeFanOut, Rebuilt)
+{
+    Drain(benchmark, [](Number** x) {
+        x[0] = NewValue();
+        x[1] = NewValue();
+    });
+}
+
+BENCHMARK(TeeFanOut, Tee)
+{
+    Drain(benchmark, [](Number** x) { Tee::Split(NewValue(), 2, x); });
+}
@@ -0,0 +1,359 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "allocatable.hpp"
+
+#include <iterator>
+#include <memory_resource>
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include "expression.hpp"
+#include "memo.hpp"
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/bihomography.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "strategy/rewrite.hpp"
+#include "strategy/strategy_mock.hpp"
+#include "strategy/transposition_table.hpp"
+#include "tee.hpp"
+#include "util.hpp"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Bihomography;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+using deepnum::clarith::strategy::StrategyMock;
+using deepnum::clarith::strategy::TranspositionTable;
+
+namespace deepnum
+{
+namespace clarith
+{
+
+class CountingResource : public std::pmr::memory_resource
+{
+ public:
+    int allocations { 0 };
+    int deallocations { 0 };
+
+ private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST_GROUP(AllocatableTest)
+{
+    CountingResource default_resource;
+    std::pmr::memory_resource* previous_default;
+
+    void setup()
+    {
+        previous_default = std::pmr::set_default_resource(&default_resource);
+    }
+
+    void teardown()
+    {
+        std::pmr::set_default_resource(previous_default);
+        mock().clear();
+    }
+};
+
+TEST(AllocatableTest, PlainNewUsesDefaultResource)
+{
+    delete new Number(new Ratio(1, 3));
+    LONGS_EQUAL(2, default_resource.allocations);
+    LONGS_EQUAL(2, default_resource.deallocations);
+}
+
+TEST(AllocatableTest, AllocatesFromSuppliedResource)
+{
+    CountingResource resource;
+    delete new (&resource) Number(new (&resource) Ratio(1, 3));
+    LONGS_EQUAL(2, resource.allocations);
+    LONGS_EQUAL(2, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, NewStrategiesComeFromSameResource)
+{
+    mock().ignoreOtherCalls();
+    CountingResource resource;
+    Number* number = new (&resource) Number(new (&resource) StrategyMock(true));
+    number->Egest();
+    delete number;
+    LONGS_EQUAL(3, resource.allocations);
+    LONGS_EQUAL(3, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, LibrarySuccessorsAreBuiltInPlace)
+{
+    CountingResource resource;
+    Number* number = new (&resource) Number(Bihomography::Sum(
+            new (&resource) Number(new (&resource) Ratio(1, 2)),
+            new (&resource) Number(new (&resource) Ratio(1, 3))));
+    while (number->Egest() != Protocol::End) {}
+    LONGS_EQUAL(Protocol::End, number->Egest());
+    delete number;
+    LONGS_EQUAL(6, resource.allocations);
+    LONGS_EQUAL(6, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, SuccessionDoesNotAllocate)
+{
+    CountingResource resource;
+    protocol::Buffer sequence = Util::ToBuffer(new (&resource) Number(new (&resource) Ratio(5, 7)));
+    // Library strategies held by pointer, each one succeeded by another.
+    Number* numbers[] = {
+        new (&resource) Number(new (&resource) Ratio(5, 7)),
+        new (&resource) Number(new (&resource) Playback(&sequence)),
+        new (&resource) Number(new (&resource) Homography(
+                new (&resource) Number(new (&resource) Playback(&sequence)), 1, 2, 0, 2)),
+        new (&resource) Number(Bihomography::Sum(
+                new (&resource) Number(new (&resource) Playback(&sequence)),
+                new (&resource) Number(new (&resource) Ratio(1, 3)))),
+    };
+    int allocations = resource.allocations;
+    for (Number* number : numbers)
+    {
+        while (number->Egest() != Protocol::End) {}
+        LONGS_EQUAL(Protocol::End, number->Egest());
+    }
+    LONGS_EQUAL(allocations, resource.allocations);
+    for (Number* number : numbers)
+    {
+        delete number;
+    }
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, RewritesTransformInputInSameResource)
+{
+    CountingResource resource;
+    // 3/4 scaled by two crosses one, which takes a Homography.
+    Number* number = new (&resource) Number(new (&resource) strategy::Scaling(
+            new (&resource) Number(new (&resource) Ratio(3, 4)), 1));
+    while (number->Egest() != Protocol::End) {}
+    delete number;
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, MadeTransformationsComeFromInputResource)
+{
+    CountingResource resource;
+    // -1/x, 3x/4 and x/2+1.
+    const int coefficients[][4] = { { 0, -2, 2, 0 }, { 3, 0, 0, 4 }, { 1, 2, 0, 2 } };
+    for (const int* c : coefficients)
+    {
+        Number* number = Homography::Make(
+                new (&resource) Number(new (&resource) Ratio(5, 7)), c[0], c[1], c[2], c[3]);
+        while (number->Egest() != Protocol::End) {}
+        delete number;
+    }
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, StackNumbersAreInputsOnceMoved)
+{
+    CountingResource resource;
+    Number x(std::in_place_type<Ratio>, 5, 7);
+    Number y(std::in_place_type<Ratio>, 1, 3);
+    Number* half = Homography::Make(new (&resource) Number(std::move(x)), 1, 2, 0, 2);
+    Number* sum = new (&resource) Number(
+            Bihomography::Sum(half, new (&resource) Number(std::move(y))));
+    protocol::Buffer result = Util::ToBuffer(sum);
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+    // x/2+1 + y
+    LONGS_EQUAL(0, Util::Compare(new Number(std::in_place_type<Playback>, std::move(result)),
+                                 new Number(std::in_place_type<Ratio>, 71, 42)));
+    CHECK_TRUE(x.Egest() == Protocol::End);
+    CHECK_TRUE(y.Egest() == Protocol::End);
+}
+
+TEST(AllocatableTest, CycleDetectorComesFromInputResource)
+{
+    CountingResource resource;
+    protocol::Buffer period;
+    period.Append(Protocol::Uncover);
+    Number* number = new (&resource) Number(new (&resource) Homography(
+            new (&resource) Number(std::in_place_type<Playback>, std::move(period), 0), 3, -1, 2, 5));
+    for (int i = 0; i < 64; ++i)
+    {
+        number->Egest();
+    }
+    delete number;
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, TransitionsComeFromInputResource)
+{
+    CountingResource resource;
+    TranspositionTable table(64);
+    TranspositionTable* previous = TranspositionTable::Install(&table);
+    // Played back, so that the input is not evaluated at construction.
+    protocol::Buffer sequence;
+    Number ratio(std::in_place_type<Ratio>, 355, 113);
+    while (!sequence.IsTerminated())
+    {
+        sequence.Append(ratio.Egest());
+    }
+    int allocations = default_resource.allocations;
+    Number* number = new (&resource) Number(new (&resource) Homography(
+            new (&resource) Number(new (&resource) Playback(&sequence)), 3, -1, 2, 5));
+    while (number->Egest() != Protocol::End) {}
+    delete number;
+    TranspositionTable::Install(previous);
+    LONGS_EQUAL(allocations, default_resource.allocations);
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+}
+
+TEST(AllocatableTest, MemoCursorsComeFromMemoizedResource)
+{
+    CountingResource resource;
+    {
+        Memo memo(new (&resource) Number(std::in_place_type<Ratio>, 355, 113));
+        for (int i = 0; i < 2; ++i)
+        {
+            Number* cursor = memo.NewCursor();
+            while (cursor->Egest() != Protocol::End) {}
+            delete cursor;
+        }
+    }
+    LONGS_EQUAL(5, resource.allocations);
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, TeeComesFromSourceResource)
+{
+    CountingResource resource;
+    Number* readers[2];
+    Tee::Split(new (&resource) Number(std::in_place_type<Ratio>, 355, 113), 2, readers);
+    for (Number* reader : readers)
+    {
+        while (reader->Egest() != Protocol::End) {}
+        delete reader;
+    }
+    LONGS_EQUAL(6, resource.allocations);
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, GraphNodesComeFromGraphResource)
+{
+    CountingResource resource;
+    {
+        Graph graph(&resource);
+        Expression x = graph.Sum(graph.Ratio(355, 113), graph.Ratio(1, 2));
+        Expression y = graph.Quotient(graph.Homography(x, 1, 1, 0, 1), graph.Homography(x, 1, -1, 0, 1));
+        for (int i = 0; i < 2; ++i)
+        {
+            Number* number = y.Evaluate();
+            while (number->Egest() != Protocol::End) {}
+            delete number;
+        }
+    }
+    CHECK_TRUE(resource.allocations > 0);
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, InPlaceStrategiesAreReplacedWithoutAllocation)
+{
+    Number* number = new Number(std::in_place_type<Homography>,
+            new Number(std::in_place_type<Ratio>, 1, 2), 1, 1, 0, 1);
+    while (number->Egest() != Protocol::End) {}
+    delete number;
+    LONGS_EQUAL(2, default_resource.allocations);
+    LONGS_EQUAL(2, default_resource.deallocations);
+}
+
+TEST(AllocatableTest, SharedPlaybackDoesNotAllocate)
+{
+    const Protocol sequence[] { Protocol::Turn, Protocol::Amplify, Protocol::Uncover, Protocol::End };
+    const protocol::Buffer buffer(std::begin(sequence), std::end(sequence));
+    int allocations = default_resource.allocations;
+    for (int i = 0; i < 3; ++i)
+    {
+        Number number(std::in_place_type<Playback>, &buffer);
+        while (number.Egest() != Protocol::End) {}
+    }
+    LONGS_EQUAL(allocations, default_resource.allocations);
+}
+
+TEST(AllocatableTest, WideComparisonDoesNotAllocate)
+{
+    CountingResource resource;
+    Number* number = new (&resource) Number(std::in_place_type<Homography>,
+            new (&resource) Number(std::in_place_type<Ratio>, 1, 3),
+            50000, 1, 1, 50000);
+    int allocations = resource.allocations;
+    while (number->Egest() != Protocol::End) {}
+    LONGS_EQUAL(allocations, resource.allocations);
+    delete number;
+    LONGS_EQUAL(resource.allocations, resource.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+TEST(AllocatableTest, GraphIsReleasedWithResource)
+{
+    CountingResource upstream;
+    std::pmr::monotonic_buffer_resource arena(&upstream);
+    Number* number = new (&arena) Number(new (&arena) Homography(
+            new (&arena) Number(new (&arena) Ratio(5, 7)), 1, 1, 0, 3));
+    number->Egest();
+    number->Egest();
+    delete number;
+    LONGS_EQUAL(0, upstream.deallocations);
+    arena.release();
+    CHECK_TRUE(upstream.allocations > 0);
+    LONGS_EQUAL(upstream.allocations, upstream.deallocations);
+    LONGS_EQUAL(0, default_resource.allocations);
+}
+
+}  // namespace clarith
+}  // namespace deepnum
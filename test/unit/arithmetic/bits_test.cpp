@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstdint>
+
+#include "arithmetic/bits.hpp"
+
+#include <CppUTest/TestHarness.h>
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace arithmetic
+{
+
+TEST_GROUP(BitsTest)
+{
+};
+
+TEST(BitsTest, MeasuresBitLength)
+{
+    LONGS_EQUAL(0, BitLength(0u));
+    LONGS_EQUAL(1, BitLength(1u));
+    LONGS_EQUAL(32, BitLength(0xFFFFFFFFu));
+    LONGS_EQUAL(64, BitLength(~std::uint64_t(0)));
+    LONGS_EQUAL(65, BitLength(static_cast<unsigned __int128>(1) << 64));
+    LONGS_EQUAL(3, BitLength(Integer(5)));
+}
+
+TEST(BitsTest, CountsTrailingZeros)
+{
+    LONGS_EQUAL(3, CountTrailingZeros(40u));
+    LONGS_EQUAL(63, CountTrailingZeros(std::uint64_t(1) << 63));
+    LONGS_EQUAL(100, CountTrailingZeros(static_cast<unsigned __int128>(3) << 100));
+    LONGS_EQUAL(100, CountTrailingZeros(Integer(3) << 100));
+}
+
+TEST(BitsTest, FindsGreatestCommonDivisor)
+{
+    LONGS_EQUAL(6, Gcd(12u, 18u));
+    LONGS_EQUAL(5, Gcd(0u, 5u));
+    LONGS_EQUAL(5, Gcd(5u, 0u));
+    LONGS_EQUAL(0, Gcd(0u, 0u));
+    LONGS_EQUAL(1, Gcd(1000000007u, 998244353u));
+    LONGS_EQUAL(1u << 31, Gcd(1u << 31, 3u << 31));
+    using U = unsigned __int128;
+    U p = 1000000007;
+    U q = 998244353;
+    CHECK_TRUE(Gcd(p * p * q << 20, p * q * q << 7) == p * q << 7);
+}
+
+}  // namespace arithmetic
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <cstdint>
+#include <limits>
+
+#include "arithmetic/integer.hpp"
+
+#include <CppUTest/TestHarness.h>
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace arithmetic
+{
+
+TEST_GROUP(IntegerTest)
+{
+};
+
+TEST(IntegerTest, ZeroHasNoSign)
+{
+    CHECK_FALSE(Integer());
+    LONGS_EQUAL(0, Integer().Sign());
+    LONGS_EQUAL(0, (-Integer(0)).Sign());
+    CHECK_TRUE(Integer(5) - Integer(5) == Integer());
+    LONGS_EQUAL(0, Integer().BitLength());
+}
+
+TEST(IntegerTest, ConvertsLowestMachineIntegers)
+{
+    CHECK_TRUE(Integer(std::numeric_limits<int>::lowest()) == Integer(-2147483648LL));
+    Integer lowest(std::numeric_limits<__int128>::lowest());
+    LONGS_EQUAL(-1, lowest.Sign());
+    LONGS_EQUAL(128, lowest.BitLength());
+    LONGS_EQUAL(127, lowest.TrailingZeros());
+    CHECK_TRUE(-lowest == Integer(static_cast<unsigned __int128>(1) << 127));
+}
+
+TEST(IntegerTest, AddsAndSubtractsAcrossLimbs)
+{
+    Integer max(std::numeric_limits<std::uint64_t>::max());
+    CHECK_TRUE(max + 1 == Integer(static_cast<unsigned __int128>(1) << 64));
+    CHECK_TRUE(max + 1 - 1 == max);
+    CHECK_TRUE(Integer(5) - Integer(7) == Integer(-2));
+    CHECK_TRUE(Integer(-5) + Integer(7) == Integer(2));
+    CHECK_TRUE(Integer(-5) - Integer(7) == Integer(-12));
+    CHECK_TRUE(-max - max == Integer(-2 * static_cast<__int128>(std::numeric_limits<std::uint64_t>::max())));
+}
+
+TEST(IntegerTest, Multiplies)
+{
+    std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+    CHECK_TRUE(Integer(max) * Integer(max)
+               == Integer(static_cast<unsigned __int128>(max) * max));
+    CHECK_TRUE(Integer(-3) * Integer(7) == Integer(-21));
+    CHECK_TRUE(Integer(-3) * Integer(-7) == Integer(21));
+    CHECK_TRUE(Integer(-3) * Integer() == Integer());
+}
+
+TEST(IntegerTest, DividesByMachineIntegers)
+{
+    Integer x = (Integer(1000000007) << 150) + 12345;
+    CHECK_TRUE((x * 1000000009 + 5) / 1000000009 == x);
+    CHECK_TRUE((x * 1000000009 + 5) % 1000000009 == Integer(5));
+    CHECK_TRUE(Integer(-7) / 2 == Integer(-3));
+    CHECK_TRUE(Integer(-7) % 2 == Integer(-1));
+}
+
+TEST(IntegerTest, ShiftsAbsoluteValue)
+{
+    Integer x = Integer(3) << 100;
+    LONGS_EQUAL(102, x.BitLength());
+    LONGS_EQUAL(100, x.TrailingZeros());
+    CHECK_TRUE(x >> 99 == Integer(6));
+    CHECK_TRUE(x >> 102 == Integer());
+    CHECK_TRUE((-x) >> 99 == Integer(-6));
+    CHECK_TRUE(Integer(-1) << 33 == Integer(-8589934592LL));
+}
+
+TEST(IntegerTest, Compares)
+{
+    Integer big = Integer(1) << 200;
+    CHECK_TRUE(-big < Integer(-1));
+    CHECK_TRUE(Integer(-1) < Integer());
+    CHECK_TRUE(Integer() < big);
+    CHECK_TRUE(big - 1 < big);
+    CHECK_TRUE(-big < -(big - 1));
+    CHECK_TRUE(big >= big);
+    CHECK_TRUE(big != -big);
+}
+
+}  // namespace arithmetic
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "expression.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <CppUTest/TestHarness.h>
+
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/ratio.hpp"
+#include "strategy/undefined_ratio_error.hpp"
+#include "util.hpp"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Ratio;
+using deepnum::clarith::strategy::UndefinedRatioError;
+
+namespace deepnum
+{
+namespace clarith
+{
+
+TEST_GROUP(ExpressionTest)
+{
+};
+
+#if __cpp_exceptions
+
+TEST(ExpressionTest, ForbidsUndefinedRatios)
+{
+    Graph graph;
+    CHECK_THROWS(UndefinedRatioError, graph.Ratio(1, 0));
+    Expression x = graph.Ratio(1, 3);
+    CHECK_THROWS(UndefinedRatioError, graph.Homography(x, 1, 1, 0, 0));
+    CHECK_THROWS(UndefinedRatioError, graph.Bihomography(x, x, 1, 0, 0, 0, 0, 0, 0, 0));
+}
+
+#endif  // __cpp_exceptions
+
+TEST(ExpressionTest, InternsEqualRatios)
+{
+    Graph graph;
+    Expression x = graph.Ratio(1, 2);
+    CHECK_TRUE(x == graph.Ratio(2, 4));
+    CHECK_TRUE(x == graph.Ratio(-3, -6));
+    CHECK_TRUE(x != graph.Ratio(-1, 2));
+    LONGS_EQUAL(1, graph.Size());
+}
+
+TEST(ExpressionTest, InternsEquivalentOperations)
+{
+    Graph graph;
+    Expression x = graph.Ratio(355, 113);
+    Expression y = graph.Ratio(-17, 12);
+    CHECK_TRUE(graph.Homography(x, 1, 1, 0, 1) == graph.Homography(x, -2, -2, 0, -2));
+    CHECK_TRUE(graph.Homography(x, 1, 1, 0, 1) != graph.Homography(y, 1, 1, 0, 1));
+    CHECK_TRUE(graph.Homography(x, 3, 0, 0, 3) == x);
+    CHECK_TRUE(graph.Sum(x, y) == graph.Sum(y, x));
+    CHECK_TRUE(graph.Product(x, y) == graph.Product(y, x));
+    CHECK_TRUE(graph.Difference(x, y) != graph.Difference(y, x));
+    CHECK_TRUE(graph.Quotient(x, y) != graph.Quotient(y, x));
+}
+
+TEST(ExpressionTest, ReleasesUnreferencedNodes)
+{
+    Graph graph;
+    Expression x = graph.Ratio(1, 3);
+    {
+        Expression z = graph.Quotient(graph.Sum(x, graph.Ratio(1, 1)), graph.Difference(x, graph.Ratio(1, 1)));
+        LONGS_EQUAL(5, graph.Size());
+        Expression w = z;
+        z = x;
+        LONGS_EQUAL(5, graph.Size());
+    }
+    LONGS_EQUAL(1, graph.Size());
+}
+
+TEST(ExpressionTest, EvaluatesToValue)
+{
+    Graph graph;
+    Expression x = graph.Ratio(1, 3);
+    Expression one = graph.Ratio(1, 1);
+    // (x+1)/(x-1) at x = 1/3 is -2.
+    Expression z = graph.Quotient(graph.Sum(x, one), graph.Difference(x, one));
+    LONGS_EQUAL(0, Util::Compare(z.Evaluate(), new Number(new Ratio(-2, 1))));
+    LONGS_EQUAL(0, Util::Compare(graph.Homography(z, 1, 0, 0, 2).Evaluate(), new Number(new Ratio(-1, 1))));
+    LONGS_EQUAL(0, Util::Compare(graph.Difference(z, z).Evaluate(), new Number(new Ratio(0, 1))));
+}
+
+TEST(ExpressionTest, ComputesSharedNodesOnce)
+{
+    Graph graph;
+    Expression x = graph.Homography(graph.Ratio(-355, 113), 1, 1, 0, 3);
+    Expression z = graph.Product(graph.Sum(x, graph.Ratio(1, 2)), graph.Difference(x, graph.Ratio(1, 2)));
+    protocol::Buffer first = Util::ToBuffer(z.Evaluate());
+    std::size_t computed = x.Computed();
+    CHECK_TRUE(computed > 0);
+    protocol::Buffer second = Util::ToBuffer(z.Evaluate());
+    LONGS_EQUAL(first.Size(), second.Size());
+    CHECK_TRUE(std::equal(first.begin(), first.end(), second.begin()));
+    LONGS_EQUAL(first.Size(), z.Computed());
+    LONGS_EQUAL(computed, x.Computed());
+}
+
+TEST(ExpressionTest, EvaluationOutlivesExpressions)
+{
+    Graph graph;
+    Number* n;
+    {
+        Expression x = graph.Ratio(5, 7);
+        n = graph.Sum(x, graph.Homography(x, 1, 0, 1, 1)).Evaluate();
+    }
+    LONGS_EQUAL(3, graph.Size());
+    // 5/7 + 5/12
+    LONGS_EQUAL(0, Util::Compare(n, new Number(new Ratio(95, 84))));
+    LONGS_EQUAL(0, graph.Size());
+}
+
+TEST(ExpressionTest, MovesExpressions)
+{
+    Graph graph;
+    Expression x = graph.Ratio(1, 3);
+    Expression y = std::move(x);
+    x = graph.Ratio(2, 3);
+    CHECK_TRUE(x != y);
+    y = std::move(x);
+    LONGS_EQUAL(1, graph.Size());
+    CHECK_TRUE(y == graph.Ratio(2, 3));
+}
+
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "memo.hpp"
+
+#include <CppUTest/TestHarness.h>
+
+#include "number.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "util.hpp"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+
+namespace deepnum
+{
+namespace clarith
+{
+
+namespace
+{
+
+// (2x+1)/(x+3) at x = 355/113, which is 823/694.
+gsl::owner<Number*> NewValue()
+{
+    Number* x = new Number(std::in_place_type<Playback>, Util::ToBuffer(new Number(new Ratio(355, 113))));
+    return new Number(std::in_place_type<Homography>, x, 2, 1, 1, 3);
+}
+
+}  // namespace
+
+TEST_GROUP(MemoTest)
+{
+};
+
+TEST(MemoTest, CursorsReadWholeNumber)
+{
+    Memo memo(NewValue());
+    for (int i = 0; i < 3; ++i)
+    {
+        LONGS_EQUAL(0, Util::Compare(memo.NewCursor(), new Number(new Ratio(823, 694))));
+    }
+    CHECK_TRUE(memo.Cache().IsTerminated());
+}
+
+TEST(MemoTest, CursorsAreIndependent)
+{
+    Memo memo(NewValue());
+    Number* oracle = NewValue();
+    Number* first = memo.NewCursor();
+    Number* second = memo.NewCursor();
+    Protocol messages[4];
+    LONGS_EQUAL(4, first->EgestMany(messages, 4));
+    Protocol message;
+    do
+    {
+        message = oracle->Egest();
+        LONGS_EQUAL(message, second->Egest());
+    } while (message != Protocol::End);
+    delete oracle;
+    oracle = NewValue();
+    for (Protocol m : messages)
+    {
+        LONGS_EQUAL(oracle->Egest(), m);
+    }
+    do
+    {
+        message = oracle->Egest();
+        LONGS_EQUAL(message, first->Egest());
+    } while (message != Protocol::End);
+    delete oracle;
+    delete first;
+    delete second;
+}
+
+TEST(MemoTest, RecordsOnlyWhatCursorsRead)
+{
+    Memo memo(NewValue());
+    Number* first = memo.NewCursor();
+    Number* second = memo.NewCursor();
+    for (int i = 0; i < 3; ++i)
+    {
+        first->Egest();
+    }
+    LONGS_EQUAL(3, memo.Cache().Size());
+    for (int i = 0; i < 2; ++i)
+    {
+        second->Egest();
+    }
+    LONGS_EQUAL(3, memo.Cache().Size());
+    Protocol messages[2];
+    LONGS_EQUAL(2, second->EgestMany(messages, 2));
+    LONGS_EQUAL(4, memo.Cache().Size());
+    delete first;
+    delete second;
+}
+
+TEST(MemoTest, ComparesAgainstMany)
+{
+    Memo memo(NewValue());
+    LONGS_EQUAL(1, Util::Compare(memo.NewCursor(), new Number(new Ratio(1, 1))));
+    LONGS_EQUAL(-1, Util::Compare(memo.NewCursor(), new Number(new Ratio(6, 5))));
+    LONGS_EQUAL(1, Util::Compare(memo.NewCursor(), new Number(new Ratio(822, 694))));
+    LONGS_EQUAL(-1, Util::Compare(memo.NewCursor(), new Number(new Ratio(824, 694))));
+    LONGS_EQUAL(0, Util::Compare(memo.NewCursor(), new Number(new Ratio(823, 694))));
+}
+
+}  // namespace clarith
+}  // namespace deepnum
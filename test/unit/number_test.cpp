@@ -23,10 +23,25 @@
 #include <CppUTest/TestHarness.h>
 #include <CppUTestExt/MockSupport.h>
 
+#include <forward_list>
+#include <utility>
+#include <vector>
+
+#include "protocol/protocol.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
 #include "strategy/zero.hpp"
 #include "strategy/strategy_mock.hpp"
+#include "strategy/undefined_ratio_error.hpp"
 
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
 using deepnum::clarith::strategy::StrategyMock;
+using deepnum::clarith::strategy::UndefinedRatioError;
+using deepnum::clarith::strategy::Zero;
 
 namespace deepnum
 {
@@ -41,6 +56,24 @@ TEST_GROUP(NumberTest)
     }
 };
 
+#if __cpp_exceptions
+
+TEST(NumberTest, KeepsRaisingOnUndefinedResult)
+{
+    Number n(std::in_place_type<Homography>, new Number(new Zero()), 1, 0, 0, 0);
+    CHECK_THROWS(UndefinedRatioError, n.Egest());
+    CHECK_THROWS(UndefinedRatioError, n.Egest());
+}
+
+TEST(NumberTest, KeepsRaisingOnUndefinedResultHeldByPointer)
+{
+    Number n(new Homography(new Number(new Zero()), 1, 0, 0, 0));
+    CHECK_THROWS(UndefinedRatioError, n.Egest());
+    CHECK_THROWS(UndefinedRatioError, n.Egest());
+}
+
+#endif  // __cpp_exceptions
+
 TEST(NumberTest, DelegatesEgestionToStrategy)
 {
     gsl::owner<StrategyMock*> strategy { new StrategyMock(false) };
@@ -58,6 +91,146 @@ TEST(NumberTest, ReplacesStrategyOnExhaustion)
     mock().checkExpectations();
 }
 
+TEST(NumberTest, InPlaceRatioEgestsLikeRatio)
+{
+    Number n1(new Ratio(-13, 7));
+    Number n2(std::in_place_type<Ratio>, -13, 7);
+    Protocol message;
+    do
+    {
+        message = n1.Egest();
+        LONGS_EQUAL(message, n2.Egest());
+    } while (message != Protocol::End);
+    LONGS_EQUAL(Protocol::End, n2.Egest());
+}
+
+TEST(NumberTest, InPlaceHomographyResumesAsRatio)
+{
+    Number n1(new Ratio(3, 1));
+    Number n2(std::in_place_type<Homography>, new Number(new Zero()), 0, 3, 0, 1);
+    Protocol message;
+    do
+    {
+        message = n1.Egest();
+        LONGS_EQUAL(message, n2.Egest());
+    } while (message != Protocol::End);
+}
+
+TEST(NumberTest, InPlacePlaybackResumesAsZero)
+{
+    Number n(std::in_place_type<Playback>, gsl::owner<std::forward_list<Protocol>*>(
+            new std::forward_list<Protocol> { Protocol::Turn, Protocol::Uncover }));
+    LONGS_EQUAL(Protocol::Turn, n.Egest());
+    LONGS_EQUAL(Protocol::Uncover, n.Egest());
+    LONGS_EQUAL(Protocol::End, n.Egest());
+    LONGS_EQUAL(Protocol::End, n.Egest());
+}
+
+TEST(NumberTest, EgestsManyUpToEnd)
+{
+    Number n1(new Ratio(-1001, 1000));
+    Number n2(std::in_place_type<Ratio>, -1001, 1000);
+    Protocol messages[64];
+    std::size_t count = n2.EgestMany(messages, 64);
+    CHECK_TRUE(count < 64);
+    LONGS_EQUAL(Protocol::End, messages[count - 1]);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        LONGS_EQUAL(n1.Egest(), messages[i]);
+    }
+}
+
+TEST(NumberTest, EgestsManyAcrossStrategies)
+{
+    Number n1(new Homography(new Number(new Ratio(2, 3)), 1, 1, 0, 1));
+    Number n2(std::in_place_type<Homography>, new Number(new Ratio(2, 3)), 1, 1, 0, 1);
+    Protocol messages[3];
+    Protocol message = Protocol::End;
+    do
+    {
+        std::size_t count = n2.EgestMany(messages, 3);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            message = n1.Egest();
+            LONGS_EQUAL(message, messages[i]);
+        }
+    } while (message != Protocol::End);
+}
+
+TEST(NumberTest, MovesInPlaceStrategies)
+{
+    Number n1(new Homography(new Number(new Ratio(2, 3)), 1, 1, 0, 1));
+    Number n2(std::in_place_type<Homography>, new Number(new Ratio(2, 3)), 1, 1, 0, 1);
+    LONGS_EQUAL(n1.Egest(), n2.Egest());
+    Number n3(std::move(n2));
+    LONGS_EQUAL(Protocol::End, n2.Egest());
+    Number n4(std::in_place_type<Ratio>, 5, 7);
+    n4 = std::move(n3);
+    LONGS_EQUAL(Protocol::End, n3.Egest());
+    Protocol message;
+    do
+    {
+        message = n1.Egest();
+        LONGS_EQUAL(message, n4.Egest());
+    } while (message != Protocol::End);
+}
+
+TEST(NumberTest, MovesPlaybackMidway)
+{
+    Number n1(std::in_place_type<Playback>, gsl::owner<std::forward_list<Protocol>*>(
+            new std::forward_list<Protocol> { Protocol::Turn, Protocol::Amplify, Protocol::Uncover }));
+    LONGS_EQUAL(Protocol::Turn, n1.Egest());
+    Number n2(std::move(n1));
+    LONGS_EQUAL(Protocol::Amplify, n2.Egest());
+    LONGS_EQUAL(Protocol::Uncover, n2.Egest());
+    LONGS_EQUAL(Protocol::End, n2.Egest());
+}
+
+TEST(NumberTest, MovesOverStrategyHeldByPointer)
+{
+    Number n1(new Ratio(-13, 7));
+    Number n2(new Ratio(11, 5));
+    n1 = std::move(n2);
+    Number n3(new Ratio(11, 5));
+    Protocol message;
+    do
+    {
+        message = n3.Egest();
+        LONGS_EQUAL(message, n1.Egest());
+    } while (message != Protocol::End);
+}
+
+TEST(NumberTest, MovedFromNumberReadsFromItsStart)
+{
+    Number n1(std::in_place_type<Ratio>, 1, 5);
+    n1.Egest();
+    Number n2(std::move(n1));
+    LONGS_EQUAL(Protocol::End, n1.Egest());
+    Number n3(std::in_place_type<Ratio>, 1, 5);
+    n3.Egest();
+    n2 = std::move(n3);
+    LONGS_EQUAL(Protocol::End, n3.Egest());
+}
+
+TEST(NumberTest, LivesInContainers)
+{
+    std::vector<Number> numbers;
+    for (int i = 1; i <= 16; ++i)
+    {
+        numbers.emplace_back(std::in_place_type<Homography>, new Number(new Ratio(i, 3)), 1, 1, 0, 1);
+    }
+    for (int i = 1; i <= 16; ++i)
+    {
+        Number n(new Ratio(i + 3, 3));
+        Protocol message;
+        do
+        {
+            message = n.Egest();
+            LONGS_EQUAL(message, numbers[i - 1].Egest());
+        } while (message != Protocol::End);
+    }
+}
+
 }  // namespace clarith
 }  // namespace deepnum
 
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "protocol/violation_error.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace protocol
+{
+
+TEST_GROUP(BufferTest)
+{
+};
+
+TEST(BufferTest, StartsEmpty)
+{
+    Buffer buffer;
+    LONGS_EQUAL(0, buffer.Size());
+    CHECK_FALSE(buffer.IsTerminated());
+    CHECK_TRUE(buffer.begin() == buffer.end());
+}
+
+TEST(BufferTest, KeepsAnyFirstMessage)
+{
+    for (Protocol message : { Protocol::End, Protocol::Amplify, Protocol::Uncover,
+                              Protocol::Turn, Protocol::Reflect, Protocol::Ground })
+    {
+        Buffer buffer;
+        buffer.Append(message);
+        LONGS_EQUAL(1, buffer.Size());
+        LONGS_EQUAL(message, buffer[0]);
+    }
+}
+
+TEST(BufferTest, IsTerminatedByEnd)
+{
+    Buffer buffer;
+    buffer.Append(Protocol::Ground);
+    buffer.Append(Protocol::Uncover);
+    CHECK_FALSE(buffer.IsTerminated());
+    buffer.Append(Protocol::End);
+    CHECK_TRUE(buffer.IsTerminated());
+    LONGS_EQUAL(3, buffer.Size());
+    LONGS_EQUAL(Protocol::End, buffer[2]);
+}
+
+TEST(BufferTest, RandomlyAccessesLongSequences)
+{
+    std::vector<Protocol> sequence { Protocol::Reflect };
+    for (int i = 0; i < 200; ++i)
+    {
+        sequence.push_back(i % 3 == 2 ? Protocol::Amplify : Protocol::Uncover);
+    }
+    sequence.push_back(Protocol::End);
+    Buffer buffer;
+    for (Protocol message : sequence)
+    {
+        buffer.Append(message);
+    }
+    LONGS_EQUAL(sequence.size(), buffer.Size());
+    for (std::size_t i = sequence.size(); i-- > 0;)
+    {
+        LONGS_EQUAL(sequence[i], buffer[i]);
+    }
+}
+
+TEST(BufferTest, IteratesInOrder)
+{
+    Buffer buffer;
+    buffer.Append(Protocol::Turn);
+    buffer.Append(Protocol::Amplify);
+    buffer.Append(Protocol::Uncover);
+    buffer.Append(Protocol::End);
+    std::vector<Protocol> sequence(buffer.begin(), buffer.end());
+    LONGS_EQUAL(4, sequence.size());
+    LONGS_EQUAL(Protocol::Turn, sequence[0]);
+    LONGS_EQUAL(Protocol::Amplify, sequence[1]);
+    LONGS_EQUAL(Protocol::Uncover, sequence[2]);
+    LONGS_EQUAL(Protocol::End, sequence[3]);
+}
+
+#if __cpp_exceptions
+
+TEST(BufferTest, ThrowsOnNonFinalEnd)
+{
+    Buffer buffer;
+    buffer.Append(Protocol::End);
+    CHECK_THROWS(ViolationError, buffer.Append(Protocol::End));
+    CHECK_THROWS(ViolationError, buffer.Append(Protocol::Uncover));
+}
+
+TEST(BufferTest, ThrowsOnFinalAmplify)
+{
+    Buffer buffer;
+    buffer.Append(Protocol::Uncover);
+    buffer.Append(Protocol::Amplify);
+    CHECK_THROWS(ViolationError, buffer.Append(Protocol::End));
+}
+
+TEST(BufferTest, ThrowsOnNonInitialTurnReflectOrGround)
+{
+    Buffer buffer;
+    buffer.Append(Protocol::Turn);
+    CHECK_THROWS(ViolationError, buffer.Append(Protocol::Turn));
+    CHECK_THROWS(ViolationError, buffer.Append(Protocol::Reflect));
+    CHECK_THROWS(ViolationError, buffer.Append(Protocol::Ground));
+}
+
+#endif  // __cpp_exceptions
+
+TEST(BufferTest, BuildsFromContiguousSequence)
+{
+    const Protocol sequence[] { Protocol::Reflect, Protocol::Amplify, Protocol::Uncover, Protocol::End };
+    Buffer buffer(std::begin(sequence), std::end(sequence));
+    LONGS_EQUAL(4, buffer.Size());
+    CHECK_TRUE(buffer.IsTerminated());
+    LONGS_EQUAL(Protocol::Uncover, buffer[2]);
+}
+
+TEST(BufferTest, ReadsConsecutiveMessages)
+{
+    std::vector<Protocol> sequence { Protocol::Turn };
+    for (int i = 0; i < 150; ++i)
+    {
+        sequence.push_back(i % 5 == 1 ? Protocol::Amplify : Protocol::Uncover);
+    }
+    sequence.push_back(Protocol::End);
+    Buffer buffer(sequence.begin(), sequence.end());
+    Protocol messages[200];
+    for (std::size_t index : { 0, 1, 63, 64, 65, 100, 151, 152 })
+    {
+        std::size_t count = buffer.Read(index, messages, 70);
+        LONGS_EQUAL(std::min<std::size_t>(70, sequence.size() - index), count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            LONGS_EQUAL(sequence[index + i], messages[i]);
+        }
+    }
+}
+
+}  // namespace protocol
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "protocol/matrix.hpp"
+#include "protocol/protocol.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace protocol
+{
+
+namespace
+{
+
+void CheckMatrix(const Matrix& expected, const Matrix& actual)
+{
+    LONGS_EQUAL(expected.a, actual.a);
+    LONGS_EQUAL(expected.b, actual.b);
+    LONGS_EQUAL(expected.c, actual.c);
+    LONGS_EQUAL(expected.d, actual.d);
+}
+
+}  // namespace
+
+TEST_GROUP(MatrixTest)
+{
+};
+
+TEST(MatrixTest, EmptyRunIsIdentity)
+{
+    CheckMatrix(Matrix { 1, 0, 0, 1 }, InputMatrix(0, 0));
+}
+
+TEST(MatrixTest, AmplifyRunsHalve)
+{
+    for (unsigned int length = 1; length <= kMaxRun; ++length)
+    {
+        CheckMatrix(Matrix { 1, 0, 0, 1 << length }, InputMatrix(0, length));
+    }
+}
+
+TEST(MatrixTest, UncoverRunsFollowFibonacci)
+{
+    int fibonacci[kMaxRun + 2] = { 0, 1 };
+    for (unsigned int i = 2; i < kMaxRun + 2; ++i)
+    {
+        fibonacci[i] = fibonacci[i - 1] + fibonacci[i - 2];
+    }
+    for (unsigned int length = 1; length <= kMaxRun; ++length)
+    {
+        CheckMatrix(Matrix { fibonacci[length - 1], fibonacci[length], fibonacci[length], fibonacci[length + 1] },
+                    InputMatrix((1u << length) - 1, length));
+    }
+}
+
+TEST(MatrixTest, TableMatchesProductOfMessages)
+{
+    for (unsigned int length = 0; length <= kMaxRun; ++length)
+    {
+        for (unsigned int bits = 0; bits < 1u << length; ++bits)
+        {
+            Matrix expected { 1, 0, 0, 1 };
+            for (unsigned int i = 0; i < length; ++i)
+            {
+                expected = expected * InputMatrix(bits >> i & 1 ? Protocol::Uncover : Protocol::Amplify);
+            }
+            CHECK_TRUE(expected == InputMatrix(bits, length));
+        }
+    }
+}
+
+TEST(MatrixTest, SubstitutesSingleMessages)
+{
+    // Reflect then Turn: x1 = -x2, x2 = 1/x3.
+    CheckMatrix(InputMatrix(Protocol::Ground), InputMatrix(Protocol::Reflect) * InputMatrix(Protocol::Turn));
+}
+
+}  // namespace protocol
+}  // namespace clarith
+}  // namespace deepnum
@@ -45,6 +45,8 @@ TEST(WatcherTest, ReturnsCopyOfInput)
     LONGS_EQUAL(Protocol::Ground, Watcher().Watch(Protocol::Ground));
 }
 
+#if __cpp_exceptions
+
 TEST(WatcherTest, ThrowsOnNonFinalEnd)
 {
     {
@@ -187,6 +189,8 @@ TEST(WatcherTest, ThrowsOnNonInitialGround)
     }
 }
 
+#endif  // __cpp_exceptions
+
 }  // namespace protocol
 }  // namespace clarith
 }  // namespace deepnum
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "statistics.hpp"
+
+#include <CppUTest/TestHarness.h>
+
+namespace deepnum
+{
+namespace clarith
+{
+
+TEST_GROUP(StatisticsTest)
+{
+};
+
+TEST(StatisticsTest, ResetsCounters)
+{
+    Statistics::Current().range_tests = 3;
+    Statistics::Current().promotions = 2;
+    Statistics::Current().reductions = 1;
+    Statistics::Current().compositions = 4;
+    Statistics::Current().evaluations = 5;
+    Statistics::Reset();
+    LONGS_EQUAL(0, Statistics::Current().range_tests);
+    LONGS_EQUAL(0, Statistics::Current().promotions);
+    LONGS_EQUAL(0, Statistics::Current().reductions);
+    LONGS_EQUAL(0, Statistics::Current().compositions);
+    LONGS_EQUAL(0, Statistics::Current().evaluations);
+}
+
+}  // namespace clarith
+}  // namespace deepnum
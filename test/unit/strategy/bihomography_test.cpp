@@ -0,0 +1,229 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "strategy/bihomography.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <variant>
+
+#include <CppUTest/TestHarness.h>
+
+#include "number.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "strategy/unavailable_error.hpp"
+#include "strategy/undefined_ratio_error.hpp"
+#include "strategy/zero.hpp"
+#include "util.hpp"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::Number;
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+#define ZERO new Number(new Zero())
+#define ONE new Number(new Ratio(1, 1))
+#define RATIO(n, d) new Number(new Ratio(n, d))
+
+// A number whose value strategies only learn message by message.
+#define STREAMED(x) new Number(new Playback(Util::ToBuffer(x)))
+
+namespace
+{
+
+// Operands, as numerator and denominator.
+constexpr int kOperands[][2] = {
+    { 0, 1 },
+    { 1, 1 },
+    { 1, 3 },
+    { -1, 2 },
+    { 355, 113 },
+    { -17, 12 },
+    { 65535, 65536 },
+    { 7, 1 },
+};
+
+template <typename Make, typename Expected>
+void CheckAllPairs(Make make, Expected expected)
+{
+    for (const auto& x : kOperands)
+    {
+        for (const auto& y : kOperands)
+        {
+            std::int64_t num, den;
+            if (!expected(x[0], x[1], y[0], y[1], &num, &den))
+            {
+                continue;
+            }
+            LONGS_EQUAL(0, Util::Compare(make(RATIO(x[0], x[1]), RATIO(y[0], y[1])), new Number(new Ratio64(num, den))));
+            LONGS_EQUAL(0, Util::Compare(make(STREAMED(RATIO(x[0], x[1])), STREAMED(RATIO(y[0], y[1]))),
+                                         new Number(new Ratio64(num, den))));
+        }
+    }
+}
+
+}  // namespace
+
+TEST_GROUP(BihomographyTest)
+{
+};
+
+#if __cpp_exceptions
+
+TEST(BihomographyTest, ForbidsUndefinedBihomography)
+{
+    CHECK_THROWS(UndefinedRatioError, Bihomography(ONE, ONE, 0, 0, 0, 0, 0, 0, 0, 0));
+}
+
+TEST(BihomographyTest, DoesNotProvideNewStrategyWhenNotExhausted)
+{
+    std::unique_ptr<Bihomography> s(Bihomography::Sum(ONE, ONE));
+    CHECK_THROWS(UnavailableError, s->GetNewStrategy(std::pmr::get_default_resource()));
+}
+
+TEST(BihomographyTest, DivisionByZeroIsUndefined)
+{
+    for (Number* x : { ZERO, ONE, RATIO(-355, 113) })
+    {
+        Number* z = ONE;
+        Number* q = new Number(Bihomography::Quotient(x, STREAMED(ZERO)));
+        CHECK_THROWS(UndefinedRatioError, Util::Compare(z, q));
+        delete z;
+        delete q;
+    }
+}
+
+#endif  // __cpp_exceptions
+
+TEST(BihomographyTest, Adds)
+{
+    CheckAllPairs(
+            [](Number* x, Number* y) { return new Number(Bihomography::Sum(x, y)); },
+            [](std::int64_t a, std::int64_t b, std::int64_t c, std::int64_t d, std::int64_t* num, std::int64_t* den) {
+                *num = a * d + c * b;
+                *den = b * d;
+                return true;
+            });
+}
+
+TEST(BihomographyTest, Subtracts)
+{
+    CheckAllPairs(
+            [](Number* x, Number* y) { return new Number(Bihomography::Difference(x, y)); },
+            [](std::int64_t a, std::int64_t b, std::int64_t c, std::int64_t d, std::int64_t* num, std::int64_t* den) {
+                *num = a * d - c * b;
+                *den = b * d;
+                return true;
+            });
+}
+
+TEST(BihomographyTest, Multiplies)
+{
+    CheckAllPairs(
+            [](Number* x, Number* y) { return new Number(Bihomography::Product(x, y)); },
+            [](std::int64_t a, std::int64_t b, std::int64_t c, std::int64_t d, std::int64_t* num, std::int64_t* den) {
+                *num = a * c;
+                *den = b * d;
+                return true;
+            });
+}
+
+TEST(BihomographyTest, Divides)
+{
+    CheckAllPairs(
+            [](Number* x, Number* y) { return new Number(Bihomography::Quotient(x, y)); },
+            [](std::int64_t a, std::int64_t b, std::int64_t c, std::int64_t d, std::int64_t* num, std::int64_t* den) {
+                *num = a * d;
+                *den = b * c;
+                return c != 0;
+            });
+}
+
+TEST(BihomographyTest, SubtractsNumberFromItself)
+{
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(Bihomography::Difference(STREAMED(RATIO(355, 113)), STREAMED(RATIO(355, 113)))),
+            ZERO));
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(Bihomography::Quotient(STREAMED(RATIO(-17, 12)), STREAMED(RATIO(-17, 12)))),
+            ONE));
+}
+
+TEST(BihomographyTest, EvaluatesGeneralForm)
+{
+    // (2xy-x+3)/(xy+y+1) at x = 1/3, y = -1/2 is 7.
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(new Bihomography(RATIO(1, 3), RATIO(-1, 2), 2, -1, 0, 3, 1, 0, 1, 1)),
+            RATIO(7, 1)));
+}
+
+TEST(BihomographyTest, EgestsManyLikeEgest)
+{
+    Bihomography s1(STREAMED(RATIO(355, 113)), STREAMED(RATIO(-17, 12)), 1, 2, 3, 4, 0, 1, -1, 5);
+    Bihomography s2(STREAMED(RATIO(355, 113)), STREAMED(RATIO(-17, 12)), 1, 2, 3, 4, 0, 1, -1, 5);
+    Protocol messages[64];
+    std::size_t count;
+    while ((count = s1.EgestMany(messages, 64)))
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Protocol message;
+            CHECK_TRUE(s2.Egest(&message));
+            LONGS_EQUAL(message, messages[i]);
+        }
+    }
+    Protocol message;
+    CHECK_FALSE(s2.Egest(&message));
+}
+
+TEST(BihomographyTest, PromotesCoefficientsOnOverflow)
+{
+    std::int64_t a = (std::int64_t(1) << 40) + 7;
+    std::int64_t b = (std::int64_t(1) << 41) - 5;
+    std::int64_t c = (std::int64_t(1) << 30) - 3;
+    std::int64_t d = (std::int64_t(1) << 31) + 11;
+    // a/b * c/d has a 128 bit denominator.
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(Bihomography::Product(new Number(new Ratio64(a, b)), new Number(new Ratio64(c, d)))),
+            new Number(new Ratio128(__int128(a) * c, __int128(b) * d))));
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(Bihomography::Sum(new Number(new Ratio64(a, b)), new Number(new Ratio64(-c, d)))),
+            new Number(new Ratio128(__int128(a) * d - __int128(c) * b, __int128(b) * d))));
+}
+
+TEST(BihomographyTest, DegeneratesToRatio)
+{
+    Bihomography s1(RATIO(1, 3), RATIO(1, 2), 0, 1, 1, 0, 0, 0, 0, 1);
+    Protocol message;
+    while (s1.Egest(&message)) {}
+    const auto& c = std::get<Bihomography::Coefficients<int>>(s1.GetResult());
+    LONGS_EQUAL(5 * c.d00, 6 * c.n00);
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "strategy/cycle.hpp"
+
+#include <CppUTest/TestHarness.h>
+
+#include "protocol/protocol.hpp"
+
+using deepnum::clarith::protocol::Protocol;
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+TEST_GROUP(CycleTest)
+{
+};
+
+TEST(CycleTest, FindsRepeatedState)
+{
+    // States 0, 1, 2, 3, 1, 2, 3, ... with one message per step.
+    Cycle cycle;
+    const Protocol output[] { Protocol::Uncover, Protocol::Amplify, Protocol::Uncover };
+    __int128 state = 0;
+    int steps = 0;
+    while (!cycle.Check(&state, 1))
+    {
+        cycle.Record(&output[state % 3], 1);
+        state = state % 3 + 1;
+        CHECK_TRUE(++steps < 100);
+    }
+    LONGS_EQUAL(3, cycle.Period().Size());
+}
+
+TEST(CycleTest, IgnoresStatesWithoutOutput)
+{
+    Cycle cycle;
+    const __int128 state = 7;
+    for (int i = 0; i < 10; ++i)
+    {
+        CHECK_FALSE(cycle.Check(&state, 1));
+    }
+}
+
+TEST(CycleTest, GivesUpOnLongCycles)
+{
+    Cycle cycle;
+    const Protocol output = Protocol::Amplify;
+    for (__int128 state = 0; !cycle.HasGivenUp(); ++state)
+    {
+        CHECK_FALSE(cycle.Check(&state, 1));
+        cycle.Record(&output, 1);
+    }
+    LONGS_EQUAL(0, cycle.Period().Size());
+}
+
+TEST(CycleTest, GivesUpOnRequest)
+{
+    Cycle cycle;
+    const __int128 state = 0;
+    const Protocol output = Protocol::Amplify;
+    cycle.GiveUp();
+    cycle.Record(&output, 1);
+    CHECK_FALSE(cycle.Check(&state, 1));
+    CHECK_TRUE(cycle.HasGivenUp());
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
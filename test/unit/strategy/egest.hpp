@@ -0,0 +1,53 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#ifndef TEST_UNIT_STRATEGY_EGEST_HPP_
+#define TEST_UNIT_STRATEGY_EGEST_HPP_
+
+#include <CppUTest/TestHarness.h>
+
+#include "protocol/protocol.hpp"
+#include "strategy/strategy.hpp"
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+// Extract next message from a strategy that is not supposed to be exhausted.
+inline protocol::Protocol Egest(Strategy& strategy)
+{
+    protocol::Protocol message;
+    CHECK_TRUE(strategy.Egest(&message));
+    return message;
+}
+
+inline protocol::Protocol Egest(Strategy&& strategy)
+{
+    return Egest(strategy);
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
+
+#endif  // TEST_UNIT_STRATEGY_EGEST_HPP_
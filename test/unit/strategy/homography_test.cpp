@@ -20,14 +20,22 @@
 
 #include "strategy/homography.hpp"
 
+#include <cstdint>
+#include <utility>
+#include <variant>
+
 #include <CppUTest/TestHarness.h>
 
+#include "arithmetic/integer.hpp"
 #include "number.hpp"
+#include "protocol/buffer.hpp"
 #include "protocol/protocol.hpp"
+#include "statistics.hpp"
 #include "strategy/zero.hpp"
+#include "strategy/playback.hpp"
 #include "strategy/ratio.hpp"
+#include "strategy/transposition_table.hpp"
 #include "strategy/unavailable_error.hpp"
-#include "strategy/exhaustion_error.hpp"
 #include "strategy/undefined_ratio_error.hpp"
 #include "util.hpp"
 
@@ -52,6 +60,9 @@ namespace strategy
 #define FOUR new Number(new Ratio(4, 1))
 #define INFINITY new Number(new Ratio(1, 0))
 
+// A number whose value strategies only learn message by message.
+#define STREAMED(x) new Number(new Playback(Util::ToBuffer(x)))
+
 #define UNITY1(x) Homography(x, 1, 0, 0, 1)
 #define UNITY2(x) Homography(x, -1, 0, 0, -1)
 // #define UNITY3(x) Homography(x, std::numeric_limits<int>::max(), 0, 0, std::numeric_limits<int>::max())
@@ -61,6 +72,8 @@ TEST_GROUP(HomographyTest)
 {
 };
 
+#if __cpp_exceptions
+
 TEST(HomographyTest, ForbidsUndefinedHomography)
 {
     CHECK_THROWS(UndefinedRatioError, Homography(ONE, 0, 0, 0, 0));
@@ -68,14 +81,17 @@ TEST(HomographyTest, ForbidsUndefinedHomography)
 
 TEST(HomographyTest, DoesNotProvideNewStrategyWhenNotExhausted)
 {
-    CHECK_THROWS(UnavailableError, UNITY1(new Number(new Ratio(0, 1))).GetNewStrategy());
+    CHECK_THROWS(UnavailableError, UNITY1(STREAMED(new Number(new Ratio(0, 1)))).GetNewStrategy(std::pmr::get_default_resource()));
 }
 
+#endif  // __cpp_exceptions
+
 TEST(HomographyTest, DegeneratesToRatioOnEndOfInput)
 {
     Homography s1 = UNITY1(ZERO);
-    CHECK_THROWS(ExhaustionError, s1.Egest());
-    Strategy* s2 = s1.GetNewStrategy();
+    Protocol message;
+    CHECK_FALSE(s1.Egest(&message));
+    Strategy* s2 = s1.GetNewStrategy(std::pmr::get_default_resource());
     CHECK_TRUE(dynamic_cast<Ratio*>(s2));
     delete s2;
 }
@@ -83,8 +99,9 @@ TEST(HomographyTest, DegeneratesToRatioOnEndOfInput)
 TEST(HomographyTest, DegeneratesToRatioOnDiscardedInput)
 {
     Homography s1(TWO, 0, 1, 0, 1);
-    CHECK_THROWS(ExhaustionError, s1.Egest());
-    Strategy* s2 = s1.GetNewStrategy();
+    Protocol message;
+    CHECK_FALSE(s1.Egest(&message));
+    Strategy* s2 = s1.GetNewStrategy(std::pmr::get_default_resource());
     CHECK_TRUE(dynamic_cast<Ratio*>(s2));
     delete s2;
 }
@@ -95,6 +112,8 @@ TEST(HomographyTest, XByXIsOneAtOne)
     LONGS_EQUAL(0, Util::Compare(ONE, new Number(new Homography(ONE, -1, 0, -1, 0))));
 }
 
+#if __cpp_exceptions
+
 TEST(HomographyTest, XByXIsUndefinedAtZero)
 {
 
@@ -157,6 +176,8 @@ TEST(HomographyTest, ZeroByXIsUndefinedAtZero)
 
 }
 
+#endif  // __cpp_exceptions
+
 TEST(HomographyTest, XByZeroIsInfinityAtOne)
 {
     LONGS_EQUAL(0, Util::Compare(INFINITY, new Number(new Homography(ONE, 1, 0, 0, 0))));
@@ -177,6 +198,8 @@ TEST(HomographyTest, MinusXByZeroIsInfinityAtMinusOne)
     LONGS_EQUAL(0, Util::Compare(INFINITY, new Number(new Homography(NEG_ONE, -1, 0, 0, 0))));
 }
 
+#if __cpp_exceptions
+
 TEST(HomographyTest, OneByXIsUndefinedAtZero)
 {
     // lim(1/x) when x approaches 0 differs according to approaching side
@@ -199,6 +222,8 @@ TEST(HomographyTest, OneByXIsUndefinedAtZero)
 
 }
 
+#endif  // __cpp_exceptions
+
 TEST(HomographyTest, XIsZeroAtZero)
 {
     LONGS_EQUAL(0, Util::Compare(ZERO, new Number(new UNITY1(ZERO))));
@@ -307,6 +332,8 @@ TEST(HomographyTest, XPlusOneReciprocatedIsZeroAtInfinity)
     LONGS_EQUAL(0, Util::Compare(new Number(new Homography(INFINITY, 0, -1, -1, -1)), ZERO));
 }
 
+#if __cpp_exceptions
+
 TEST(HomographyTest, XPlusOneReciprocatedIsUndefinedAtMinusOne)
 {
 
@@ -328,6 +355,8 @@ TEST(HomographyTest, XPlusOneReciprocatedIsUndefinedAtMinusOne)
 
 }
 
+#endif  // __cpp_exceptions
+
 TEST(HomographyTest, XPlusOneOverXPlusOneIsOneAtMinusInfinity)
 {
     LONGS_EQUAL(0, Util::Compare(new Number(new Homography(NEG_INFINITY, 1, 1, 1, 1)), ONE));
@@ -340,6 +369,400 @@ TEST(HomographyTest, XPlusOneOverXPlusOneIsOneAtInfinity)
     LONGS_EQUAL(0, Util::Compare(new Number(new Homography(INFINITY, -1, -1, -1, -1)), ONE));
 }
 
+TEST(HomographyTest, EgestsManyLikeEgest)
+{
+    Homography s1(STREAMED(new Number(new Ratio(355, 113))), 1, 1, -1, 3);
+    Homography s2(STREAMED(new Number(new Ratio(355, 113))), 1, 1, -1, 3);
+    Protocol messages[64];
+    std::size_t count;
+    while ((count = s1.EgestMany(messages, 64)))
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Protocol message;
+            CHECK_TRUE(s2.Egest(&message));
+            LONGS_EQUAL(message, messages[i]);
+        }
+    }
+    Protocol message;
+    CHECK_FALSE(s2.Egest(&message));
+}
+
+TEST(HomographyTest, EgestsNoMoreThanAsked)
+{
+    Homography s1(STREAMED(new Number(new Ratio(355, 113))), 4, 0, 0, 1);
+    Protocol messages[1];
+    LONGS_EQUAL(1, s1.EgestMany(messages, 1));
+}
+
+
+TEST(HomographyTest, KeepsNativeCoefficientsOnShortInputs)
+{
+    Homography s1(STREAMED(new Number(new Ratio(355, 113))), 1, 1, -1, 3);
+    Protocol message;
+    while (s1.Egest(&message)) {}
+    CHECK_TRUE(std::holds_alternative<Homography::Coefficients<int>>(s1.GetResult()));
+}
+
+TEST(HomographyTest, PromotesCoefficientsOnOverflow)
+{
+    // (3x+1)/(x+2) at x = a/b is (3a+b)/(a+2b).
+    __int128 a = (__int128(1000000007) << 70) + 1;
+    __int128 b = (__int128(999999937) << 70) + 3;
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(new Homography(new Number(new Ratio128(a, b)), 3, 1, 1, 2)),
+            new Number(new Ratio128(3 * a + b, a + 2 * b))));
+    LONGS_EQUAL(-1, Util::Compare(
+            new Number(new Homography(new Number(new Ratio128(a, b)), 3, 1, 1, 2)),
+            new Number(new Ratio128(3 * a + b + 1, a + 2 * b))));
+}
+
+TEST(HomographyTest, PromotesCoefficientsToArbitraryPrecision)
+{
+    arithmetic::Integer a = (arithmetic::Integer(1000000007) << 190) + 1;
+    arithmetic::Integer b = -(arithmetic::Integer(999999937) << 190) - 3;
+    Homography s1(new Number(new BigRatio(a, b)), 3, 1, 1, 2);
+    Protocol message;
+    while (s1.Egest(&message)) {}
+    CHECK_TRUE(std::holds_alternative<Homography::Coefficients<arithmetic::Integer>>(s1.GetResult()));
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(new Homography(new Number(new BigRatio(a, b)), 3, 1, 1, 2)),
+            new Number(new BigRatio(3 * a + b, a + 2 * b))));
+}
+
+TEST(HomographyTest, NestedHomographiesPromoteIndependently)
+{
+    // 1/(1-(3x+1)/(x+2)) at x = a/b is (a+2b)/(b-2a).
+    std::int64_t a = (std::int64_t(1) << 40) + 7;
+    std::int64_t b = (std::int64_t(1) << 41) - 5;
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(new Homography(
+                    new Number(new Homography(STREAMED(new Number(new Ratio64(a, b))), 3, 1, 1, 2)),
+                    0, 1, -1, 1)),
+            new Number(new Ratio64(a + 2 * b, b - 2 * a))));
+}
+
+
+TEST(HomographyTest, StaysExactNearWidestMachineIntegers)
+{
+    // Coefficients grow close to the __int128 limits.
+    __int128 huge = __int128(1) << 120;
+    LONGS_EQUAL(-1, Util::Compare(
+            new Number(new Homography(new Number(new Ratio128(huge - 1, huge)), 1, 0, 0, 1)),
+            new Number(new Ratio128(huge + 1, huge + 2))));
+    LONGS_EQUAL(1, Util::Compare(
+            new Number(new Homography(new Number(new Ratio128(-huge + 1, huge)), 1, 0, 0, 1)),
+            new Number(new Ratio128(-huge - 1, huge + 2))));
+}
+
+namespace
+{
+
+// (3x+1)/(x+2) with a large odd common factor in every coefficient.
+constexpr int kFactor = 531441;
+
+gsl::owner<Number*> ScaledHomography(Homography::Reduction reduction)
+{
+    return new Number(std::in_place_type<Homography>, STREAMED(new Number(new Ratio(100003, 99991))),
+            3 * kFactor, kFactor, kFactor, 2 * kFactor, reduction);
+}
+
+}  // namespace
+
+TEST(HomographyTest, ReducesCoefficientsBeforePromoting)
+{
+    Homography s1(STREAMED(new Number(new Ratio(100003, 99991))), 3 * kFactor, kFactor, kFactor, 2 * kFactor);
+    Protocol message;
+    while (s1.Egest(&message)) {}
+    CHECK_TRUE(std::holds_alternative<Homography::Coefficients<int>>(s1.GetResult()));
+    Homography s2(STREAMED(new Number(new Ratio(100003, 99991))), 3 * kFactor, kFactor, kFactor, 2 * kFactor,
+                  Homography::Reduction::Never);
+    while (s2.Egest(&message)) {}
+    CHECK_FALSE(std::holds_alternative<Homography::Coefficients<int>>(s2.GetResult()));
+}
+
+TEST(HomographyTest, ReductionPoliciesAgree)
+{
+    Number* oracle = new Number(new Ratio(3 * 100003 + 99991, 100003 + 2 * 99991));
+    Number* never = ScaledHomography(Homography::Reduction::Never);
+    Number* on_overflow = ScaledHomography(Homography::Reduction::OnOverflow);
+    Number* always = ScaledHomography(Homography::Reduction::Always);
+    Protocol message;
+    do
+    {
+        message = oracle->Egest();
+        LONGS_EQUAL(message, never->Egest());
+        LONGS_EQUAL(message, on_overflow->Egest());
+        LONGS_EQUAL(message, always->Egest());
+    } while (message != Protocol::End);
+    delete oracle;
+    delete never;
+    delete on_overflow;
+    delete always;
+}
+
+namespace
+{
+
+// Chain of homographies (n1x+n0)/(d1x+d0) over x.
+gsl::owner<Number*> Chain(gsl::owner<Number*> x, int depth, int n1, int n0, int d1, int d0)
+{
+    for (int i = 0; i < depth; ++i)
+    {
+        x = new Number(new Homography(x, n1, n0, d1, d0));
+    }
+    return x;
+}
+
+}  // namespace
+
+TEST(HomographyTest, FoldsAffineChains)
+{
+    // Twenty times x+1/2 is x+10.
+    LONGS_EQUAL(0, Util::Compare(
+            Chain(STREAMED(new Number(new Ratio(355, 113))), 20, 2, 1, 0, 2),
+            new Number(new Ratio(355 + 10 * 113, 113))));
+    // 1/(x+10+1)
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(new Homography(Chain(STREAMED(new Number(new Ratio(355, 113))), 20, 2, 1, 0, 2), 0, 1, 1, 1)),
+            new Number(new Ratio(113, 355 + 11 * 113))));
+}
+
+TEST(HomographyTest, KeepsNestedFormWhenCompositionOverflows)
+{
+    LONGS_EQUAL(0, Util::Compare(
+            Chain(STREAMED(new Number(new Ratio(1, 3))), 40, 2, 0, 0, 1),
+            new Number(new Ratio64(std::int64_t(1) << 40, 3))));
+}
+
+#if __cpp_exceptions
+
+TEST(HomographyTest, FoldingKeepsPoles)
+{
+    // 2/x+1 and 1/(1/x+1) are undefined at 0, as 1/x is.
+    for (Number* h : { new Number(new Homography(new Number(new Homography(ZERO, 0, 1, 1, 0)), 2, 1, 0, 1)),
+                       new Number(new Homography(new Number(new Homography(ZERO, 0, 1, 1, 0)), 0, 1, 1, 1)) })
+    {
+        Number* z = ONE;
+        CHECK_THROWS(UndefinedRatioError, Util::Compare(z, h));
+        delete z;
+        delete h;
+    }
+}
+
+#endif  // __cpp_exceptions
+
+TEST(HomographyTest, EvaluatesKnownInputs)
+{
+    // (x+1)/(3-x) at 355/113 is -117/4.
+    Homography s1(new Number(new Ratio(355, 113)), 1, 1, -1, 3);
+    const auto& c = std::get<Homography::Coefficients<int>>(s1.GetResult());
+    LONGS_EQUAL(117, c.n0);
+    LONGS_EQUAL(-4, c.d0);
+    CHECK_TRUE(std::holds_alternative<Homography::Coefficients<int>>(
+            Homography(ZERO, 1, 1, -1, 3).GetResult()));
+    LONGS_EQUAL(0, Util::Compare(
+            Chain(new Number(new Ratio(1, 3)), 5, 3, 1, 1, 2),
+            Chain(STREAMED(new Number(new Ratio(1, 3))), 5, 3, 1, 1, 2)));
+}
+
+TEST(HomographyTest, EvaluatesIntoWideCoefficients)
+{
+    std::int64_t big = std::int64_t(1) << 62;
+    Homography s1(new Number(new Ratio64(big, 1)), 4, 0, 0, 1);
+    CHECK_TRUE(std::holds_alternative<Homography::Coefficients<__int128>>(s1.GetResult()));
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(new Homography(new Number(new Ratio64(big, 3)), 4, 0, 0, 1)),
+            new Number(new Ratio128(__int128(1) << 64, 3))));
+}
+
+TEST(HomographyTest, MakeChoosesLightestStrategy)
+{
+    Number* x = STREAMED(new Number(new Ratio(355, 113)));
+    CHECK_TRUE(Homography::Make(x, 1, 0, 0, 1) == x);
+    delete x;
+    // -4x, -1/x, (3x+1)/2 and (3x+1)/(x+2) of -17/12.
+    for (const auto& c : {
+            std::pair(Homography::Make(STREAMED(new Number(new Ratio(-17, 12))), -4, 0, 0, 1),
+                      new Number(new Ratio(17, 3))),
+            std::pair(Homography::Make(STREAMED(new Number(new Ratio(-17, 12))), 0, -2, 2, 0),
+                      new Number(new Ratio(12, 17))),
+            std::pair(Homography::Make(STREAMED(new Number(new Ratio(-17, 12))), 3, 1, 0, 2),
+                      new Number(new Ratio(-13, 8))),
+            std::pair(Homography::Make(new Number(new Ratio(-17, 12)), 3, 1, 0, 2),
+                      new Number(new Ratio(-13, 8))),
+            std::pair(Homography::Make(STREAMED(new Number(new Ratio(-17, 12))), 3, 1, 1, 2),
+                      new Number(new Ratio(-39, 7))) })
+    {
+        LONGS_EQUAL(0, Util::Compare(c.first, c.second));
+    }
+}
+
+namespace
+{
+
+// A number whose Protocol sequence is "1" forever.
+Number* Periodic()
+{
+    protocol::Buffer period;
+    period.Append(Protocol::Uncover);
+    return new Number(std::in_place_type<Playback>, std::move(period), 0);
+}
+
+// The same number, hidden from cycle detection.
+Number* Aperiodic()
+{
+    protocol::Buffer period;
+    period.Append(Protocol::Uncover);
+    return new Number(new Playback(std::move(period), 0));
+}
+
+// Checks a few thousand messages of two numbers for equality.
+void CheckSameMessages(Number* x, Number* y)
+{
+    for (int i = 0; i < 5000; ++i)
+    {
+        LONGS_EQUAL(y->Egest(), x->Egest());
+    }
+    delete x;
+    delete y;
+}
+
+}  // namespace
+
+TEST(HomographyTest, DetectsPeriodicOutput)
+{
+    Homography s1(Periodic(), 3, -1, 2, 5);
+    Number* reference = new Number(new Homography(Aperiodic(), 3, -1, 2, 5));
+    Protocol message;
+    int count = 0;
+    for (; count < 5000 && s1.Egest(&message); ++count)
+    {
+        LONGS_EQUAL(reference->Egest(), message);
+    }
+    CHECK_TRUE(count < 5000);
+    const protocol::Buffer* period = s1.GetPeriod();
+    CHECK_TRUE(period);
+    CHECK_TRUE(period->Size() > 0);
+    Number* replay = new Number(s1.GetNewStrategy(std::pmr::get_default_resource()));
+    CheckSameMessages(replay, reference);
+}
+
+TEST(HomographyTest, ReplaysPeriodicOutputInPlace)
+{
+    CheckSameMessages(
+            new Number(std::in_place_type<Homography>, Periodic(), 1, 2, 3, 4),
+            new Number(new Homography(Aperiodic(), 1, 2, 3, 4)));
+}
+
+TEST(HomographyTest, DetectsPeriodicOutputOfPeriodicOutput)
+{
+    Homography s1(new Number(std::in_place_type<Homography>, Periodic(), 1, 0, 1, 1), 2, 1, 1, 3);
+    Protocol message;
+    int count = 0;
+    while (count < 5000 && s1.Egest(&message))
+    {
+        ++count;
+    }
+    CHECK_TRUE(count < 5000);
+    CHECK_TRUE(s1.GetPeriod());
+    CheckSameMessages(
+            new Number(std::in_place_type<Homography>,
+                       new Number(std::in_place_type<Homography>, Periodic(), 1, 0, 1, 1), 2, 1, 1, 3),
+            new Number(new Homography(new Number(new Homography(Aperiodic(), 1, 0, 1, 1)), 2, 1, 1, 3)));
+}
+
+#if __cpp_exceptions
+
+TEST(HomographyTest, HasNoRatioWhenPeriodic)
+{
+    Homography s1(Periodic(), 1, 1, 0, 1);
+    Protocol message;
+    while (s1.Egest(&message)) {}
+    CHECK_THROWS(UnavailableError, s1.GetResult());
+}
+
+#endif  // __cpp_exceptions
+
+TEST(HomographyTest, AgreesWithTranspositionTable)
+{
+    constexpr int kInputs[][2] = { { 355, 113 }, { -17, 12 }, { 65535, 65536 }, { 1000003, 999983 } };
+    constexpr int kCoefficients[][4] = { { 1, 1, -1, 3 }, { 3, 1, 1, 2 }, { 50000, 1, 1, 50000 } };
+    TranspositionTable table(1024);
+    // Twice over, so that the second round finds what the first one cached.
+    for (int round = 0; round < 2; ++round)
+    {
+        for (const auto& x : kInputs)
+        {
+            for (const auto& c : kCoefficients)
+            {
+                Number* oracle = new Number(new Homography(
+                        STREAMED(new Number(new Ratio(x[0], x[1]))), c[0], c[1], c[2], c[3]));
+                TranspositionTable* previous = TranspositionTable::Install(&table);
+                Number* number = new Number(std::in_place_type<Homography>,
+                        STREAMED(new Number(new Ratio(x[0], x[1]))), c[0], c[1], c[2], c[3]);
+                TranspositionTable::Install(previous);
+                Protocol message;
+                do
+                {
+                    message = oracle->Egest();
+                    LONGS_EQUAL(message, number->Egest());
+                } while (message != Protocol::End);
+                delete oracle;
+                delete number;
+            }
+        }
+    }
+    CHECK_TRUE(table.Hits() > 0);
+    CHECK_TRUE(table.Misses() > 0);
+}
+
+#if STATISTICS
+
+TEST(HomographyTest, CountsRangeTests)
+{
+    Statistics::Reset();
+    Number number(std::in_place_type<Homography>, STREAMED(new Number(new Ratio(355, 113))), 50000, 1, 1, 50000);
+    while (number.Egest() != Protocol::End) {}
+    CHECK_TRUE(Statistics::Current().range_tests > 0);
+}
+
+TEST(HomographyTest, CountsReductionsAndPromotions)
+{
+    Statistics::Reset();
+    Number* number = ScaledHomography(Homography::Reduction::Always);
+    while (number->Egest() != Protocol::End) {}
+    delete number;
+    CHECK_TRUE(Statistics::Current().reductions > 0);
+    LONGS_EQUAL(0, Statistics::Current().promotions);
+    number = ScaledHomography(Homography::Reduction::Never);
+    while (number->Egest() != Protocol::End) {}
+    delete number;
+    CHECK_TRUE(Statistics::Current().promotions > 0);
+}
+
+TEST(HomographyTest, CountsCompositions)
+{
+    Statistics::Reset();
+    delete Chain(STREAMED(new Number(new Ratio(1, 3))), 3, 1, 1, 0, 2);
+    LONGS_EQUAL(2, Statistics::Current().compositions);
+    Statistics::Reset();
+    delete Chain(STREAMED(new Number(new Ratio(1, 3))), 3, 1, 1, 1, 2);
+    LONGS_EQUAL(0, Statistics::Current().compositions);
+}
+
+TEST(HomographyTest, CountsEvaluations)
+{
+    Statistics::Reset();
+    delete Chain(new Number(new Ratio(1, 3)), 3, 1, 1, 1, 2);
+    LONGS_EQUAL(3, Statistics::Current().evaluations);
+    Statistics::Reset();
+    delete Chain(STREAMED(new Number(new Ratio(1, 3))), 3, 1, 1, 1, 2);
+    LONGS_EQUAL(0, Statistics::Current().evaluations);
+}
+
+#endif  // STATISTICS
+
 }  // namespace strategy
 }  // namespace clarith
 }  // namespace deepnum
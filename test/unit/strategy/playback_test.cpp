@@ -19,12 +19,14 @@
  */
 
 #include <forward_list>
+#include <iterator>
 
+#include "protocol/buffer.hpp"
 #include "protocol/protocol.hpp"
 #include "protocol/violation_error.hpp"
 #include "strategy/zero.hpp"
+#include "strategy/egest.hpp"
 #include "strategy/playback.hpp"
-#include "strategy/exhaustion_error.hpp"
 #include "strategy/unavailable_error.hpp"
 
 #include <CppUTest/TestHarness.h>
@@ -46,53 +48,60 @@ TEST_GROUP(PlaybackTest)
 TEST(PlaybackTest, ReachesZero)
 {
     Playback s1(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> {}));
-    CHECK_THROWS(ExhaustionError, s1.Egest());
-    Strategy* s2 = s1.GetNewStrategy();
+    Protocol message;
+    CHECK_FALSE(s1.Egest(&message));
+    Strategy* s2 = s1.GetNewStrategy(std::pmr::get_default_resource());
     CHECK_TRUE(dynamic_cast<Zero*>(s2));
     delete s2;
 }
 
+#if __cpp_exceptions
+
 TEST(PlaybackTest, DoesNotOfferPrematureStrategy)
 {
-    CHECK_THROWS(UnavailableError, Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Uncover })).GetNewStrategy());
+    CHECK_THROWS(UnavailableError, Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Uncover })).GetNewStrategy(std::pmr::get_default_resource()));
 }
 
+#endif  // __cpp_exceptions
+
 TEST(PlaybackTest, ReplaysEnd)
 {
-    LONGS_EQUAL(Protocol::End, Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::End })).Egest());
+    LONGS_EQUAL(Protocol::End, Egest(Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::End }))));
 }
 
 TEST(PlaybackTest, ReplaysAmplify)
 {
-    LONGS_EQUAL(Protocol::Amplify, Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Amplify })).Egest());
+    LONGS_EQUAL(Protocol::Amplify, Egest(Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Amplify }))));
 }
 
 TEST(PlaybackTest, ReplaysUncover)
 {
-    LONGS_EQUAL(Protocol::Uncover, Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Uncover })).Egest());
+    LONGS_EQUAL(Protocol::Uncover, Egest(Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Uncover }))));
 }
 
 TEST(PlaybackTest, ReplaysTurn)
 {
-    LONGS_EQUAL(Protocol::Turn, Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Turn })).Egest());
+    LONGS_EQUAL(Protocol::Turn, Egest(Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Turn }))));
 }
 
 TEST(PlaybackTest, ReplaysReflect)
 {
-    LONGS_EQUAL(Protocol::Reflect, Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Reflect })).Egest());
+    LONGS_EQUAL(Protocol::Reflect, Egest(Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Reflect }))));
 }
 
 TEST(PlaybackTest, ReplaysGround)
 {
-    LONGS_EQUAL(Protocol::Ground, Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Ground })).Egest());
+    LONGS_EQUAL(Protocol::Ground, Egest(Playback(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Ground }))));
 }
 
+#if __cpp_exceptions
+
 TEST(PlaybackTest, ThrowsOnNonFinalEnd)
 {
     {
         Playback strategy(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::End, Protocol::Uncover }));
-        LONGS_EQUAL(Protocol::End, strategy.Egest());
-        CHECK_THROWS(ViolationError, strategy.Egest());
+        LONGS_EQUAL(Protocol::End, Egest(strategy));
+        CHECK_THROWS(ViolationError, Egest(strategy));
     }
 }
 
@@ -100,8 +109,26 @@ TEST(PlaybackTest, ThrowsOnFinalAmplify)
 {
     {
         Playback strategy(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Amplify }));
-        LONGS_EQUAL(Protocol::Amplify, strategy.Egest());
-        CHECK_THROWS(ViolationError, strategy.Egest());
+        LONGS_EQUAL(Protocol::Amplify, Egest(strategy));
+        CHECK_THROWS(ViolationError, Egest(strategy));
+    }
+}
+
+TEST(PlaybackTest, ThrowsOnFinalAmplifyOfBuffer)
+{
+    const Protocol sequence[] { Protocol::Uncover, Protocol::Amplify };
+    const protocol::Buffer buffer(std::begin(sequence), std::end(sequence));
+    {
+        Playback strategy(&buffer);
+        LONGS_EQUAL(Protocol::Uncover, Egest(strategy));
+        LONGS_EQUAL(Protocol::Amplify, Egest(strategy));
+        CHECK_THROWS(ViolationError, Egest(strategy));
+    }
+    {
+        Playback strategy(buffer);
+        Protocol out[4];
+        LONGS_EQUAL(2, strategy.EgestMany(out, 4));
+        CHECK_THROWS(ViolationError, strategy.EgestMany(out, 4));
     }
 }
 
@@ -109,8 +136,8 @@ TEST(PlaybackTest, ThrowsOnNonInitialTurn)
 {
     {
         Playback strategy(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Uncover, Protocol::Turn }));
-        LONGS_EQUAL(Protocol::Uncover, strategy.Egest());
-        CHECK_THROWS(ViolationError, strategy.Egest());
+        LONGS_EQUAL(Protocol::Uncover, Egest(strategy));
+        CHECK_THROWS(ViolationError, Egest(strategy));
     }
 }
 
@@ -118,8 +145,8 @@ TEST(PlaybackTest, ThrowsOnNonInitialReflect)
 {
     {
         Playback strategy(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Uncover, Protocol::Reflect }));
-        LONGS_EQUAL(Protocol::Uncover, strategy.Egest());
-        CHECK_THROWS(ViolationError, strategy.Egest());
+        LONGS_EQUAL(Protocol::Uncover, Egest(strategy));
+        CHECK_THROWS(ViolationError, Egest(strategy));
     }
 }
 
@@ -127,9 +154,95 @@ TEST(PlaybackTest, ThrowsOnNonInitialGround)
 {
     {
         Playback strategy(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Uncover, Protocol::Ground }));
-        LONGS_EQUAL(Protocol::Uncover, strategy.Egest());
-        CHECK_THROWS(ViolationError, strategy.Egest());
+        LONGS_EQUAL(Protocol::Uncover, Egest(strategy));
+        CHECK_THROWS(ViolationError, Egest(strategy));
+    }
+}
+
+TEST(PlaybackTest, ThrowsOnPeriodicHead)
+{
+    const Protocol sequence[] { Protocol::Turn, Protocol::Uncover };
+    CHECK_THROWS(ViolationError, Playback(protocol::Buffer(std::begin(sequence), std::end(sequence)), 0));
+}
+
+TEST(PlaybackTest, ThrowsOnPeriodicEnd)
+{
+    const Protocol sequence[] { Protocol::Uncover, Protocol::End };
+    CHECK_THROWS(ViolationError, Playback(protocol::Buffer(std::begin(sequence), std::end(sequence)), 0));
+}
+
+TEST(PlaybackTest, DoesNotOfferStrategyWhenPeriodic)
+{
+    const Protocol sequence[] { Protocol::Uncover };
+    Playback s1(protocol::Buffer(std::begin(sequence), std::end(sequence)), 0);
+    CHECK_THROWS(UnavailableError, s1.GetNewStrategy(std::pmr::get_default_resource()));
+}
+
+#endif  // __cpp_exceptions
+
+TEST(PlaybackTest, EgestsManyInOneCall)
+{
+    Playback s1(gsl::owner<std::forward_list<Protocol>*>(new std::forward_list<Protocol> { Protocol::Turn, Protocol::Uncover, Protocol::Amplify, Protocol::Uncover }));
+    Protocol messages[8];
+    LONGS_EQUAL(4, s1.EgestMany(messages, 8));
+    LONGS_EQUAL(Protocol::Turn, messages[0]);
+    LONGS_EQUAL(Protocol::Uncover, messages[3]);
+    LONGS_EQUAL(0, s1.EgestMany(messages, 8));
+}
+
+TEST(PlaybackTest, ReplaysBuffer)
+{
+    protocol::Buffer buffer;
+    buffer.Append(Protocol::Ground);
+    buffer.Append(Protocol::Uncover);
+    buffer.Append(Protocol::End);
+    Playback s1(buffer);
+    LONGS_EQUAL(Protocol::Ground, Egest(s1));
+    LONGS_EQUAL(Protocol::Uncover, Egest(s1));
+    LONGS_EQUAL(Protocol::End, Egest(s1));
+    Protocol message;
+    CHECK_FALSE(s1.Egest(&message));
+    Strategy* s2 = s1.GetNewStrategy(std::pmr::get_default_resource());
+    CHECK_TRUE(dynamic_cast<Zero*>(s2));
+    delete s2;
+}
+
+TEST(PlaybackTest, SharesBuffer)
+{
+    const Protocol sequence[] { Protocol::Reflect, Protocol::Uncover, Protocol::Amplify, Protocol::Uncover, Protocol::End };
+    const protocol::Buffer buffer(std::begin(sequence), std::end(sequence));
+    Playback s1(&buffer);
+    Playback s2(&buffer);
+    Protocol messages[8];
+    LONGS_EQUAL(Protocol::Reflect, Egest(s1));
+    LONGS_EQUAL(5, s2.EgestMany(messages, 8));
+    LONGS_EQUAL(4, s1.EgestMany(messages + 1, 7));
+    LONGS_EQUAL(5, buffer.Size());
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        LONGS_EQUAL(sequence[i], messages[i]);
+    }
+}
+
+TEST(PlaybackTest, ReplaysPeriodically)
+{
+    // A head and a "1" prefix, then "21" forever.
+    const Protocol sequence[] { Protocol::Ground, Protocol::Uncover, Protocol::Amplify, Protocol::Uncover };
+    Playback s1(protocol::Buffer(std::begin(sequence), std::end(sequence)), 2);
+    Playback s2(protocol::Buffer(std::begin(sequence), std::end(sequence)), 2);
+    CHECK_TRUE(s1.IsPeriodic());
+    Protocol messages[7];
+    for (int round = 0; round < 3; ++round)
+    {
+        LONGS_EQUAL(7, s1.EgestMany(messages, 7));
+        for (Protocol message : messages)
+        {
+            LONGS_EQUAL(message, Egest(s2));
+        }
     }
+    LONGS_EQUAL(Protocol::Amplify, messages[6]);
+    LONGS_EQUAL(3, s1.Position());
+    LONGS_EQUAL(3, s2.Position());
 }
 
 }  // namespace strategy
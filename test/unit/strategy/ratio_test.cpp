@@ -18,12 +18,17 @@
  * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
  */
 
+#include <cstdint>
+#include <limits>
+
+#include "number.hpp"
 #include "protocol/protocol.hpp"
-#include "strategy/exhaustion_error.hpp"
+#include "strategy/egest.hpp"
 #include "strategy/zero.hpp"
 #include "strategy/ratio.hpp"
 #include "strategy/unavailable_error.hpp"
 #include "strategy/undefined_ratio_error.hpp"
+#include "util.hpp"
 
 #include <CppUTest/TestHarness.h>
 
@@ -127,6 +132,8 @@ TEST(RatioTest, ParsesSignedParameters8)
     CHECK_TRUE(ratio.GetPositive());
 }
 
+#if __cpp_exceptions
+
 TEST(RatioTest, ThrowsOnUndefinedRatio)
 {
     CHECK_THROWS(UndefinedRatioError, TestableRatio(0, 0, true));
@@ -134,14 +141,17 @@ TEST(RatioTest, ThrowsOnUndefinedRatio)
 
 TEST(RatioTest, DoesNotProvideNewStrategyOnNonZeroRatio)
 {
-    CHECK_THROWS(UnavailableError, TestableRatio(1, 1, true).GetNewStrategy());
+    CHECK_THROWS(UnavailableError, TestableRatio(1, 1, true).GetNewStrategy(std::pmr::get_default_resource()));
 }
 
+#endif  // __cpp_exceptions
+
 TEST(RatioTest, DegeneratesToZero1)
 {
     TestableRatio s1(0, 1, true);
-    CHECK_THROWS(ExhaustionError, s1.Egest());
-    Strategy* s2 = s1.GetNewStrategy();
+    Protocol message;
+    CHECK_FALSE(s1.Egest(&message));
+    Strategy* s2 = s1.GetNewStrategy(std::pmr::get_default_resource());
     CHECK_TRUE(dynamic_cast<Zero*>(s2));
     delete s2;
 }
@@ -149,51 +159,171 @@ TEST(RatioTest, DegeneratesToZero1)
 TEST(RatioTest, DegeneratesToZero2)
 {
     TestableRatio s1(0, std::numeric_limits<unsigned int>::max(), true);
-    CHECK_THROWS(ExhaustionError, s1.Egest());
-    Strategy* s2 = s1.GetNewStrategy();
+    Protocol message;
+    CHECK_FALSE(s1.Egest(&message));
+    Strategy* s2 = s1.GetNewStrategy(std::pmr::get_default_resource());
     CHECK_TRUE(dynamic_cast<Zero*>(s2));
     delete s2;
 }
 
 TEST(RatioTest, CanExpressOneHalf1)
 {
-    LONGS_EQUAL(Protocol::Amplify, TestableRatio(1, 2, true).Egest());
+    LONGS_EQUAL(Protocol::Amplify, Egest(TestableRatio(1, 2, true)));
 }
 
 TEST(RatioTest, CanExpressOneHalf2)
 {
     LONGS_EQUAL(Protocol::Amplify,
-                TestableRatio(std::numeric_limits<unsigned int>::max() / 2,
-                      std::numeric_limits<unsigned int>::max(),
-                      true).Egest());
+                Egest(TestableRatio(std::numeric_limits<unsigned int>::max() / 2,
+                                    std::numeric_limits<unsigned int>::max(),
+                                    true)));
 }
 
 TEST(RatioTest, CanExpressOne1)
 {
-    LONGS_EQUAL(Protocol::Uncover, TestableRatio(1, 1, true).Egest());
+    LONGS_EQUAL(Protocol::Uncover, Egest(TestableRatio(1, 1, true)));
 }
 
 TEST(RatioTest, CanExpressOne2)
 {
     LONGS_EQUAL(Protocol::Uncover,
-                TestableRatio(std::numeric_limits<unsigned int>::max(),
-                      std::numeric_limits<unsigned int>::max(),
-                      true).Egest());
+                Egest(TestableRatio(std::numeric_limits<unsigned int>::max(),
+                                    std::numeric_limits<unsigned int>::max(),
+                                    true)));
 }
 
 TEST(RatioTest, CanExpressTwo)
 {
-    LONGS_EQUAL(Protocol::Turn, TestableRatio(2, 1, true).Egest());
+    LONGS_EQUAL(Protocol::Turn, Egest(TestableRatio(2, 1, true)));
 }
 
 TEST(RatioTest, CanExpressMinusOne)
 {
-    LONGS_EQUAL(Protocol::Reflect, TestableRatio(1, 1, false).Egest());
+    LONGS_EQUAL(Protocol::Reflect, Egest(TestableRatio(1, 1, false)));
 }
 
 TEST(RatioTest, CanExpressMinusTwo)
 {
-    LONGS_EQUAL(Protocol::Ground, TestableRatio(2, 1, false).Egest());
+    LONGS_EQUAL(Protocol::Ground, Egest(TestableRatio(2, 1, false)));
+}
+
+TEST(RatioTest, EgestsManyInOneCall)
+{
+    Ratio s1(-1001, 1000);
+    Ratio s2(-1001, 1000);
+    Protocol messages[64];
+    std::size_t count = s1.EgestMany(messages, 64);
+    CHECK_TRUE(count > 0 && count < 64);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        LONGS_EQUAL(Egest(s2), messages[i]);
+    }
+    Protocol message;
+    CHECK_FALSE(s2.Egest(&message));
+    LONGS_EQUAL(0, s1.EgestMany(messages, 64));
+}
+
+TEST(RatioTest, EgestsNoMoreThanAsked)
+{
+    Ratio s1(-1001, 1000);
+    Protocol messages[2];
+    LONGS_EQUAL(2, s1.EgestMany(messages, 2));
+}
+
+TEST(RatioTest, EgestsAmplifyRunAtOnce)
+{
+    TestableRatio s1(1u, 0x80000000u, true);
+    Protocol messages[64];
+    LONGS_EQUAL(32, s1.EgestMany(messages, 64));
+    for (std::size_t i = 0; i < 31; ++i)
+    {
+        LONGS_EQUAL(Protocol::Amplify, messages[i]);
+    }
+    LONGS_EQUAL(Protocol::Uncover, messages[31]);
+}
+
+TEST(RatioTest, SplitsAmplifyRunsLikeEgest)
+{
+    const unsigned int ratios[][2] = {
+        { 3u, 1000000007u },
+        { 5u, 3u << 20 },
+        { 1u, 0xFFFFFFFFu },
+        { 12345u, 0x80000000u },
+    };
+    for (const auto& ratio : ratios)
+    {
+        TestableRatio s1(ratio[0], ratio[1], true);
+        TestableRatio s2(ratio[0], ratio[1], true);
+        Protocol messages[5];
+        std::size_t count;
+        while ((count = s1.EgestMany(messages, 5)))
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                LONGS_EQUAL(Egest(s2), messages[i]);
+            }
+            LONGS_EQUAL(s2.GetNum(), s1.GetNum());
+            LONGS_EQUAL(s2.GetDen(), s1.GetDen());
+        }
+        Protocol message;
+        CHECK_FALSE(s2.Egest(&message));
+    }
+}
+
+TEST(RatioTest, ParsesLowestSignedParameters)
+{
+    Ratio64 s1(std::numeric_limits<std::int64_t>::lowest(), 1);
+    Ratio64 s2(std::uint64_t(1) << 63, 1, false);
+    Protocol message;
+    while (s2.Egest(&message))
+    {
+        LONGS_EQUAL(message, Egest(s1));
+    }
+    CHECK_FALSE(s1.Egest(&message));
+}
+
+TEST(RatioTest, WideRatiosEgestLikeNarrowRatios)
+{
+    Ratio s1(-1001, 1000);
+    Ratio64 s2(-1001, 1000);
+    Ratio128 s3(-1001, 1000);
+    Protocol message;
+    while (s1.Egest(&message))
+    {
+        LONGS_EQUAL(message, Egest(s2));
+        LONGS_EQUAL(message, Egest(s3));
+    }
+    CHECK_FALSE(s2.Egest(&message));
+    CHECK_FALSE(s3.Egest(&message));
+}
+
+TEST(RatioTest, WideRatiosKeepPrecision)
+{
+    const std::int64_t big = std::int64_t(1) << 62;
+    LONGS_EQUAL(-1, Util::Compare(new Number(new Ratio64(big - 1, big)),
+                                  new Number(new Ratio64(big, big + 1))));
+    const __int128 huge = __int128(1) << 120;
+    LONGS_EQUAL(-1, Util::Compare(new Number(new Ratio128(-huge, huge - 1)),
+                                  new Number(new Ratio128(-huge - 1, huge))));
+    LONGS_EQUAL(0, Util::Compare(new Number(new Ratio128(huge, 3 * huge)),
+                                 new Number(new Ratio(1, 3))));
+}
+
+TEST(RatioTest, WideRatiosEgestAmplifyRunsLikeEgest)
+{
+    Ratio128 s1(3, __int128(1000000007) << 90);
+    Ratio128 s2(3, __int128(1000000007) << 90);
+    Protocol messages[16];
+    std::size_t count;
+    while ((count = s1.EgestMany(messages, 16)))
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            LONGS_EQUAL(Egest(s2), messages[i]);
+        }
+    }
+    Protocol message;
+    CHECK_FALSE(s2.Egest(&message));
 }
 
 }  // namespace strategy
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "strategy/rewrite.hpp"
+
+#include <vector>
+
+#include <CppUTest/TestHarness.h>
+
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "strategy/unavailable_error.hpp"
+#include "strategy/undefined_ratio_error.hpp"
+#include "strategy/zero.hpp"
+#include "util.hpp"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::Number;
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+#define ZERO new Number(new Zero())
+#define RATIO(n, d) new Number(new Ratio(n, d))
+#define STREAMED(x) new Number(new Playback(Util::ToBuffer(x)))
+
+namespace
+{
+
+// Inputs, as numerator and denominator; covering every head and both signs of one.
+constexpr int kInputs[][2] = {
+    { 1, 1 },
+    { -1, 1 },
+    { 1, 2 },
+    { -1, 2 },
+    { 2, 1 },
+    { -2, 1 },
+    { 3, 4 },
+    { 355, 113 },
+    { -17, 12 },
+    { 1, 1024 },
+    { -3, 2048 },
+    { 65535, 65536 },
+    { 65536, 65535 },
+    { -1000003, 999983 },
+};
+
+__int128 Power(int exponent)
+{
+    return __int128(1) << exponent;
+}
+
+// Number playing back a sequence, such as one for infinity.
+Number* Played(const std::vector<Protocol>& sequence)
+{
+    return new Number(new Playback(protocol::Buffer(sequence.begin(), sequence.end())));
+}
+
+// Messages of a number, up to and including its end.
+std::vector<Protocol> Read(Number* x)
+{
+    std::vector<Protocol> messages { x->Egest() };
+    while (messages.back() != Protocol::End)
+    {
+        messages.push_back(x->Egest());
+    }
+    delete x;
+    return messages;
+}
+
+}  // namespace
+
+TEST_GROUP(RewriteTest)
+{
+};
+
+#if __cpp_exceptions
+
+TEST(RewriteTest, DoesNotProvideNewStrategy)
+{
+    Negation s1(RATIO(1, 3));
+    Protocol message;
+    CHECK_TRUE(s1.Egest(&message));
+    CHECK_THROWS(UnavailableError, s1.GetNewStrategy(std::pmr::get_default_resource()));
+}
+
+TEST(RewriteTest, ReciprocalOfZeroIsUndefined)
+{
+    Reciprocation s1(ZERO);
+    Protocol message;
+    CHECK_THROWS(UndefinedRatioError, s1.Egest(&message));
+}
+
+#endif  // __cpp_exceptions
+
+TEST(RewriteTest, NegatesZero)
+{
+    LONGS_EQUAL(0, Util::Compare(new Number(new Negation(ZERO)), ZERO));
+    LONGS_EQUAL(0, Util::Compare(new Number(new Scaling(ZERO, 5)), ZERO));
+    LONGS_EQUAL(0, Util::Compare(new Number(new Scaling(ZERO, -5)), ZERO));
+}
+
+TEST(RewriteTest, KeepsInfinityAndZero)
+{
+    const std::vector<Protocol> infinity { Protocol::Turn, Protocol::End };
+    const std::vector<Protocol> minus_infinity { Protocol::Ground, Protocol::End };
+    const std::vector<Protocol> zero { Protocol::End };
+    for (const auto& x : { infinity, minus_infinity, zero })
+    {
+        for (int exponent : { 1, -1, 5, -5 })
+        {
+            CHECK(x == Read(new Number(new Scaling(Played(x), exponent))));
+        }
+    }
+    CHECK(minus_infinity == Read(new Number(new Negation(Played(infinity)))));
+    CHECK(zero == Read(new Number(new Negation(Played(zero)))));
+}
+
+TEST(RewriteTest, Negates)
+{
+    for (const auto& x : kInputs)
+    {
+        LONGS_EQUAL(0, Util::Compare(new Number(new Negation(STREAMED(RATIO(x[0], x[1])))), RATIO(-x[0], x[1])));
+    }
+}
+
+TEST(RewriteTest, Reciprocates)
+{
+    for (const auto& x : kInputs)
+    {
+        LONGS_EQUAL(0, Util::Compare(new Number(new Reciprocation(STREAMED(RATIO(x[0], x[1])))), RATIO(x[1], x[0])));
+    }
+}
+
+TEST(RewriteTest, Scales)
+{
+    for (const auto& x : kInputs)
+    {
+        for (int exponent = -40; exponent <= 40; ++exponent)
+        {
+            Number* expected = exponent >= 0
+                    ? new Number(new Ratio128(x[0] * Power(exponent), x[1]))
+                    : new Number(new Ratio128(x[0], x[1] * Power(-exponent)));
+            LONGS_EQUAL(0, Util::Compare(new Number(new Scaling(STREAMED(RATIO(x[0], x[1])), exponent)), expected));
+        }
+    }
+}
+
+TEST(RewriteTest, EgestsManyLikeEgest)
+{
+    for (int exponent : { -70, -3, 0, 2, 70 })
+    {
+        Scaling s1(STREAMED(RATIO(-17, 12)), exponent);
+        Scaling s2(STREAMED(RATIO(-17, 12)), exponent);
+        Protocol messages[16];
+        std::size_t count;
+        do
+        {
+            count = s1.EgestMany(messages, 16);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                Protocol message;
+                CHECK_TRUE(s2.Egest(&message));
+                LONGS_EQUAL(message, messages[i]);
+            }
+        } while (messages[count - 1] != Protocol::End);
+    }
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
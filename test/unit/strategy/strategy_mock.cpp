@@ -19,8 +19,8 @@
  */
 
 #include "protocol/protocol.hpp"
+#include "raise.hpp"
 #include "strategy/strategy_mock.hpp"
-#include "strategy/exhaustion_error.hpp"
 #include "strategy/unavailable_error.hpp"
 
 #include <CppUTestExt/MockSupport.h>
@@ -39,24 +39,25 @@ StrategyMock::StrategyMock(bool exhausted)
 {
 }
 
-Protocol StrategyMock::Egest()
+bool StrategyMock::Egest(Protocol* message)
 {
     mock().actualCall("Egest").onObject(this);
     if (exhausted_)
     {
-        throw ExhaustionError();
+        return false;
     }
-    return Protocol::End;
+    *message = Protocol::End;
+    return true;
 }
 
-gsl::owner<Strategy*> StrategyMock::GetNewStrategy() const
+gsl::owner<Strategy*> StrategyMock::GetNewStrategy(std::pmr::memory_resource* resource) const
 {
     mock().actualCall("GetNewStrategy").onObject(this);
     if (!exhausted_)
     {
-        throw UnavailableError();
+        Raise<UnavailableError>();
     }
-    return gsl::owner<StrategyMock*>(new StrategyMock);
+    return gsl::owner<StrategyMock*>(new (resource) StrategyMock);
 }
 
 }  // namespace strategy
@@ -37,8 +37,8 @@ class StrategyMock : public Strategy
 {
  public:
     StrategyMock(bool exhausted = false);
-    protocol::Protocol Egest() override;
-    gsl::owner<Strategy*> GetNewStrategy() const override;
+    bool Egest(protocol::Protocol* message) override;
+    gsl::owner<Strategy*> GetNewStrategy(std::pmr::memory_resource* resource) const override;
 
  private:
     bool exhausted_ { false };
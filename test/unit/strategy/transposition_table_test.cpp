@@ -0,0 +1,88 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "strategy/transposition_table.hpp"
+
+#include <CppUTest/TestHarness.h>
+
+#include "protocol/protocol.hpp"
+
+using deepnum::clarith::protocol::Protocol;
+
+namespace deepnum
+{
+namespace clarith
+{
+namespace strategy
+{
+
+TEST_GROUP(TranspositionTableTest)
+{
+};
+
+TEST(TranspositionTableTest, RoundsCapacityToPowerOfTwo)
+{
+    LONGS_EQUAL(1, TranspositionTable(0).Capacity());
+    LONGS_EQUAL(64, TranspositionTable(64).Capacity());
+    LONGS_EQUAL(128, TranspositionTable(65).Capacity());
+}
+
+TEST(TranspositionTableTest, FindsStoredTransitions)
+{
+    TranspositionTable table(16);
+    const TranspositionTable::Key key { { 1, 2, 3, 4 }, 0x5a };
+    CHECK_FALSE(table.Find(key));
+    const Protocol output[] { Protocol::Uncover, Protocol::Amplify };
+    table.Store(key, { 5, 6, 7, 8 }, true, output, 2);
+    const TranspositionTable::Entry* entry = table.Find(key);
+    CHECK_TRUE(entry);
+    LONGS_EQUAL(8, entry->state[3]);
+    CHECK_TRUE(entry->pole_in_range);
+    LONGS_EQUAL(2, entry->size);
+    LONGS_EQUAL(Protocol::Amplify, Protocol(entry->output[1]));
+    CHECK_FALSE(table.Find(TranspositionTable::Key { { 1, 2, 3, 4 }, 0x5b }));
+    CHECK_FALSE(table.Find(TranspositionTable::Key { { 1, 2, 3, 5 }, 0x5a }));
+    LONGS_EQUAL(1, table.Hits());
+    LONGS_EQUAL(3, table.Misses());
+}
+
+TEST(TranspositionTableTest, EvictsOnCollision)
+{
+    TranspositionTable table(1);
+    const TranspositionTable::Key first { { 1, 0, 0, 1 }, 0 };
+    const TranspositionTable::Key second { { 1, 0, 0, 2 }, 0 };
+    table.Store(first, { 1, 0, 0, 1 }, false, nullptr, 0);
+    table.Store(second, { 1, 0, 0, 2 }, false, nullptr, 0);
+    CHECK_FALSE(table.Find(first));
+    CHECK_TRUE(table.Find(second));
+}
+
+TEST(TranspositionTableTest, InstallsPerThread)
+{
+    TranspositionTable table(16);
+    TranspositionTable* previous = TranspositionTable::Install(&table);
+    POINTERS_EQUAL(&table, TranspositionTable::Current());
+    POINTERS_EQUAL(&table, TranspositionTable::Install(previous));
+    POINTERS_EQUAL(previous, TranspositionTable::Current());
+}
+
+}  // namespace strategy
+}  // namespace clarith
+}  // namespace deepnum
@@ -23,6 +23,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "protocol/protocol.hpp"
+#include "strategy/egest.hpp"
 #include "strategy/unavailable_error.hpp"
 
 using deepnum::clarith::protocol::Protocol;
@@ -40,12 +41,23 @@ TEST_GROUP(ZeroTest)
 
 TEST(ZeroTest, IsZero)
 {
-    LONGS_EQUAL(Protocol::End, Zero().Egest());
+    LONGS_EQUAL(Protocol::End, Egest(Zero()));
 }
 
+#if __cpp_exceptions
+
 TEST(ZeroTest, DoesNotProvideNewStrategy)
 {
-    CHECK_THROWS(UnavailableError, Zero().GetNewStrategy());
+    CHECK_THROWS(UnavailableError, Zero().GetNewStrategy(std::pmr::get_default_resource()));
+}
+
+#endif  // __cpp_exceptions
+
+TEST(ZeroTest, EgestsEndOnlyOnce)
+{
+    Protocol messages[4];
+    LONGS_EQUAL(1, Zero().EgestMany(messages, 4));
+    LONGS_EQUAL(Protocol::End, messages[0]);
 }
 
 }  // namespace strategy
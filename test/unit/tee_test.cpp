@@ -0,0 +1,124 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "tee.hpp"
+
+#include <utility>
+
+#include <CppUTest/TestHarness.h>
+
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/bihomography.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "util.hpp"
+
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Bihomography;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+
+namespace deepnum
+{
+namespace clarith
+{
+
+namespace
+{
+
+gsl::owner<Number*> NewStreamed(int n, int d)
+{
+    return new Number(std::in_place_type<Playback>, Util::ToBuffer(new Number(new Ratio(n, d))));
+}
+
+// A number whose Protocol sequence never ends.
+gsl::owner<Number*> NewEndless()
+{
+    protocol::Buffer period;
+    period.Append(Protocol::Uncover);
+    period.Append(Protocol::Amplify);
+    return new Number(std::in_place_type<Playback>, std::move(period), 0);
+}
+
+}  // namespace
+
+TEST_GROUP(TeeTest)
+{
+};
+
+TEST(TeeTest, ReadersHaveSourceValue)
+{
+    Number* readers[3];
+    Tee::Split(NewStreamed(-355, 113), 3, readers);
+    for (Number* reader : readers)
+    {
+        LONGS_EQUAL(0, Util::Compare(reader, new Number(new Ratio(-355, 113))));
+    }
+}
+
+TEST(TeeTest, ComputesSourceOnce)
+{
+    // (x+1)/(x-1) at x = 355/113 is 468/242.
+    Number* readers[2];
+    Tee::Split(NewStreamed(355, 113), 2, readers);
+    Number* quotient = new Number(Bihomography::Quotient(
+            new Number(std::in_place_type<Homography>, readers[0], 1, 1, 0, 1),
+            new Number(std::in_place_type<Homography>, readers[1], 1, -1, 0, 1)));
+    LONGS_EQUAL(0, Util::Compare(quotient, new Number(new Ratio(468, 242))));
+}
+
+TEST(TeeTest, TrimsWhatAllReadersPassed)
+{
+    Number* readers[2];
+    const Tee* tee = Tee::Split(NewEndless(), 2, readers);
+    for (int i = 0; i < 10000; ++i)
+    {
+        LONGS_EQUAL(readers[0]->Egest(), readers[1]->Egest());
+        CHECK_TRUE(tee->Buffered() <= 2);
+    }
+    delete readers[0];
+    delete readers[1];
+}
+
+TEST(TeeTest, KeepsWhatSlowReadersNeed)
+{
+    Number* readers[3];
+    const Tee* tee = Tee::Split(NewEndless(), 3, readers);
+    Protocol fast[100];
+    LONGS_EQUAL(100, readers[0]->EgestMany(fast, 100));
+    LONGS_EQUAL(100, tee->Buffered());
+    for (Protocol message : fast)
+    {
+        LONGS_EQUAL(message, readers[1]->Egest());
+    }
+    // Deleted readers hold nothing back.
+    delete readers[2];
+    readers[0]->Egest();
+    CHECK_TRUE(tee->Buffered() <= 1);
+    delete readers[0];
+    delete readers[1];
+}
+
+}  // namespace clarith
+}  // namespace deepnum
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2019 Rafael Lorandi <coolparadox@gmail.com>
+ *
+ * This file is part of dn-clarith, a library for performing arithmetic
+ * in continued logarithm representation.
+ * 
+ * dn-clarith is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * dn-clarith is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with dn-clarith.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include <utility>
+
+#include "number.hpp"
+#include "protocol/buffer.hpp"
+#include "protocol/protocol.hpp"
+#include "strategy/homography.hpp"
+#include "strategy/playback.hpp"
+#include "strategy/ratio.hpp"
+#include "util.hpp"
+
+#include <CppUTest/TestHarness.h>
+
+using deepnum::clarith::protocol::Buffer;
+using deepnum::clarith::protocol::Protocol;
+using deepnum::clarith::strategy::Homography;
+using deepnum::clarith::strategy::Playback;
+using deepnum::clarith::strategy::Ratio;
+
+namespace deepnum
+{
+namespace clarith
+{
+
+TEST_GROUP(ToBufferTest)
+{
+};
+
+TEST(ToBufferTest, HoldsWholeSequence)
+{
+    Buffer buffer = Util::ToBuffer(new Number(new Ratio(-355, 113)));
+    CHECK_TRUE(buffer.IsTerminated());
+    Number number(new Ratio(-355, 113));
+    for (Protocol message : buffer)
+    {
+        LONGS_EQUAL(number.Egest(), message);
+    }
+}
+
+TEST(ToBufferTest, HoldsZero)
+{
+    Buffer buffer = Util::ToBuffer(new Number(new Ratio(0, 1)));
+    LONGS_EQUAL(1, buffer.Size());
+    LONGS_EQUAL(Protocol::End, buffer[0]);
+}
+
+TEST(ToBufferTest, PlaysBackIntoNumber)
+{
+    Buffer buffer = Util::ToBuffer(new Number(new Homography(
+            new Number(new Ratio(22, 7)), 3, 1, -1, 5)));
+    LONGS_EQUAL(0, Util::Compare(
+            new Number(std::in_place_type<Playback>, std::move(buffer)),
+            new Number(new Ratio(3 * 22 + 7, -22 + 5 * 7))));
+}
+
+}  // namespace clarith
+}  // namespace deepnum